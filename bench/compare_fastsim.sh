@@ -0,0 +1,46 @@
+#!/bin/sh
+# Run macros/fastsim_validate.mac and compare the full and parametrized
+# responses: shape of the Edep spectrum (chi2/ndf of the normalized
+# histograms) and the mean number of photons at the window per event.
+#
+#   bench/compare_fastsim.sh [sim executable] [max chi2/ndf] [relative tolerance]
+set -e
+
+SIM=${1:-./sim}
+MAXCHI2=${2:-3}
+TOL=${3:-0.1}
+
+"$SIM" macros/fastsim_validate.mac > fastsim_validate.log 2>&1
+grep "Wall time" fastsim_validate.log | awk '{ printf "run %d wall %s s\n", NR, $(NF-3) }'
+
+awk -v maxchi2="$MAXCHI2" -v tol="$TOL" '
+    FNR == 1 { f++ }
+    /^histogram/ { name = $2; n = $3; lo = $4; hi = $5; slot = -1; next }
+    /^#/ { next }
+    {
+        slot++
+        if (slot < 1 || slot > n) next
+        c[f, name, slot] = $1; tot[f, name] += $1
+        sum[f, name] += $1 * (lo + (slot - 0.5) * (hi - lo) / n)
+        nbins[name] = n
+    }
+    function mean(i, h) { return tot[i, h] > 0 ? sum[i, h] / tot[i, h] : 0 }
+    END {
+        chi2 = 0; ndf = -1
+        for (s = 1; s <= nbins["Edep"]; s++) {
+            a = c[1, "Edep", s]; b = c[2, "Edep", s]
+            if (a + b == 0) continue
+            na = tot[1, "Edep"]; nb = tot[2, "Edep"]
+            chi2 += (a / na - b / nb) ^ 2 / (a / na ^ 2 + b / nb ^ 2); ndf++
+        }
+        r = (ndf > 0) ? chi2 / ndf : 0
+        ok1 = r <= maxchi2
+        printf "%-24s chi2/ndf %.3f (%d) %s\n", "Edep shape", r, ndf, ok1 ? "OK" : "FAIL"
+
+        m1 = mean(1, "Aluminum"); m2 = mean(2, "Aluminum")
+        d = (m1 != 0) ? (m2 - m1) / m1 : 0
+        ok2 = (d < 0 ? -d : d) <= tol
+        printf "%-24s full %-12.6g fast %-12.6g diff %+.2f%% %s\n", "aluminum/event", m1, m2, 100 * d, ok2 ? "OK" : "FAIL"
+        printf "%-24s full %-12.6g fast %-12.6g\n", "Edep [MeV/event]", mean(1, "Edep"), mean(2, "Edep")
+        exit !(ok1 && ok2)
+    }' simulation_output_fastsim_full_hist.txt simulation_output_fastsim_fast_hist.txt
@@ -0,0 +1,46 @@
+#!/bin/sh
+# Run macros/physics_validate.mac with the full and lean physics lists and
+# compare energy deposit and photon counts per event. Also reports the wall
+# time of the whole process (dominated by startup for short runs) and peak RSS.
+#
+#   bench/compare_physics.sh [sim executable] [relative tolerance]
+set -e
+
+SIM=${1:-./sim}
+TOL=${2:-0.05}
+MACRO=macros/physics_validate.mac
+
+run() {
+    /usr/bin/time -f "PMTIME %e %M" "$SIM" "$MACRO" --physics "$1" > "physics_$1.log" 2>&1
+}
+
+summary() {
+    awk -v cfg="$1" '
+        /Events:/                       { events = $NF }
+        /Total Optical Photons:/        { optical = $NF }
+        /Detected at Aluminum:/         { aluminum = $(NF-2) }
+        /Energy Deposited in NaI:/      { edep = $(NF-3) }
+        /^PMTIME/                       { wall = $2; rss = $3 }
+        END { printf "%s %d %.6g %.6g %.6g %.3f %d\n", cfg, events,
+              edep / events, optical / events, aluminum / events, wall, rss }
+    ' "physics_$1.log"
+}
+
+run full
+run lean
+{ summary full; summary lean; } | awk -v tol="$TOL" '
+    { cfg[NR] = $1; edep[NR] = $3; opt[NR] = $4; al[NR] = $5; wall[NR] = $6; rss[NR] = $7 }
+    function check(name, ref, val) {
+        d = (ref != 0) ? (val - ref) / ref : 0
+        ok = (d < 0 ? -d : d) <= tol
+        printf "%-22s full %-12.6g lean %-12.6g diff %+.2f%% %s\n", name, ref, val, 100 * d, ok ? "OK" : "FAIL"
+        if (!ok) failed = 1
+    }
+    END {
+        check("Edep [MeV/event]", edep[1], edep[2])
+        check("optical/event", opt[1], opt[2])
+        check("aluminum/event", al[1], al[2])
+        printf "%-22s full %-12.3f lean %-12.3f saved %.3f s\n", "wall [s]", wall[1], wall[2], wall[1] - wall[2]
+        printf "%-22s full %-12d lean %-12d saved %d kB\n", "peak RSS [kB]", rss[1], rss[2], rss[1] - rss[2]
+        exit failed
+    }'
@@ -0,0 +1,36 @@
+#!/bin/sh
+# Reference throughput sweep: 0.662, 1.33 and 5 MeV gammas, optical photons
+# tracked or killed at birth, 1 thread and all cores. Every configuration
+# runs in its own sim_bench process with the same seed; the records are
+# collected into one JSON array.
+#
+#   bench/run_bench.sh [sim_bench executable] [events] [output.json]
+set -e
+
+BENCH=${1:-./sim_bench}
+EVENTS=${2:-200}
+OUT=${3:-bench_results.json}
+SEED=12345
+NCORES=$(nproc 2>/dev/null || echo 1)
+
+TMP=$(mktemp)
+trap 'rm -f "$TMP"' EXIT
+
+first=1
+echo "[" > "$OUT"
+for energy in 0.662 1.33 5; do
+    for optical in on off; do
+        for threads in 1 "$NCORES"; do
+            "$BENCH" --energy "$energy" --optical "$optical" --threads "$threads" \
+                     --events "$EVENTS" --seed "$SEED" --json "$TMP" > /dev/null
+            [ $first -eq 1 ] || echo "," >> "$OUT"
+            first=0
+            tr -d '\n' < "$TMP" >> "$OUT"
+            echo "energy=$energy optical=$optical threads=$threads done" >&2
+            [ "$threads" = 1 ] && [ "$NCORES" = 1 ] && break
+        done
+    done
+done
+echo "" >> "$OUT"
+echo "]" >> "$OUT"
+echo "Results written to $OUT" >&2
@@ -0,0 +1,26 @@
+#!/bin/sh
+# Run macros/shard.mac as N shards of E events each, merge them with
+# pm_reduce and compare against one process running N*E events on all
+# cores with the same master seed.
+#
+#   bench/shard_check.sh [sim executable] [pm_reduce executable] [shards] [events per shard] [seed]
+set -e
+
+SIM=${1:-./sim}
+REDUCE=${2:-./pm_reduce}
+SHARDS=${3:-4}
+EVENTS=${4:-50}
+SEED=${5:-12345}
+
+i=0
+stems=""
+while [ "$i" -lt "$SHARDS" ]; do
+    PM_EVENTS=$EVENTS "$SIM" macros/shard.mac -t 1 --seed "$SEED" --shard "$i/$SHARDS" \
+        > "shard_$i.log" 2>&1
+    stems="$stems simulation_output_shard_shard$i"
+    i=$((i + 1))
+done
+"$REDUCE" merge simulation_output_shard_merged $stems
+
+PM_EVENTS=$((EVENTS * SHARDS)) "$SIM" macros/shard.mac --seed "$SEED" > shard_reference.log 2>&1
+"$REDUCE" compare simulation_output_shard_merged simulation_output_shard
@@ -0,0 +1,192 @@
+// Headless event-throughput benchmark on the production geometry, physics
+// list and user actions. One configuration per process; bench/run_bench.sh
+// sweeps the reference set and collects the JSON records.
+//
+//   ./sim_bench [--energy MeV] [--optical on|off|fast] [--threads N]
+//               [--events N] [--seed S] [--physics full|lean] [--fastsim on|off]
+//               [--stack eager|lazy] [--json FILE]
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4Threading.hh"
+#include "G4Version.hh"
+#include "G4SystemOfUnits.hh"
+#include "PMSetup.hh"
+#include "PMRunAction.hh"
+#include "PMLog.hh"
+#include "PMOpticalResponse.hh"
+#include "PMOutputManager.hh"
+#include "PMFastScintillatorModel.hh"
+#include "PMStackingAction.hh"
+#include "PMAllocCounter.hh"
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+struct BenchOptions {
+    G4double energy = 0.662;
+    G4String optical = "on";
+    G4int nThreads = 1;
+    G4int nEvents = 1000;
+    long seed = 12345;
+    G4String physics = "full";
+    G4String fastsim = "off";
+    G4String stack = "eager";
+    G4String jsonFile;
+};
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [options]\n"
+                 "  --energy MeV          gamma energy (default 0.662)\n"
+                 "  --optical on|off|fast track optical photons, kill them at birth, or use the map\n"
+                 "  --threads N           worker threads (default 1)\n"
+                 "  --events N            events to simulate (default 1000)\n"
+                 "  --seed S              master random seed (default 12345)\n"
+                 "  --physics full|lean   physics list configuration (default full)\n"
+                 "  --fastsim on|off      parametrized crystal response (default off)\n"
+                 "  --stack eager|lazy    scintillation photon stacking (default eager)\n"
+                 "  --json FILE           write the result to FILE instead of stdout\n",
+                 program);
+}
+
+BenchOptions Parse(int argc, char** argv) {
+    BenchOptions options;
+    for (G4int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!std::strcmp(arg, "-h") || !std::strcmp(arg, "--help")) {
+            PrintUsage(argv[0]);
+            std::exit(0);
+        }
+        if (!value) {
+            PrintUsage(argv[0]);
+            std::exit(1);
+        }
+        if (!std::strcmp(arg, "--energy"))       options.energy = std::atof(value);
+        else if (!std::strcmp(arg, "--optical")) options.optical = value;
+        else if (!std::strcmp(arg, "--threads")) options.nThreads = std::atoi(value);
+        else if (!std::strcmp(arg, "--events"))  options.nEvents = std::atoi(value);
+        else if (!std::strcmp(arg, "--seed"))    options.seed = std::atol(value);
+        else if (!std::strcmp(arg, "--physics")) options.physics = value;
+        else if (!std::strcmp(arg, "--fastsim")) options.fastsim = value;
+        else if (!std::strcmp(arg, "--stack"))   options.stack = value;
+        else if (!std::strcmp(arg, "--json"))    options.jsonFile = value;
+        else {
+            PrintUsage(argv[0]);
+            std::exit(1);
+        }
+        ++i;
+    }
+    if (options.nThreads <= 0) {
+        options.nThreads = G4Threading::G4GetNumberOfCores();
+    }
+    return options;
+}
+
+// ru_maxrss is in kilobytes on Linux.
+long PeakRSSKilobytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+G4double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options = Parse(argc, argv);
+    auto processStart = std::chrono::steady_clock::now();
+
+    // Same start-up as sim and sim_batch; the seed also enables per-event
+    // reseeding, as sim --seed does.
+    G4RunManager* runManager = PMSetup::CreateRunManager(options.nThreads);
+    PMSetup::InitSingletons();
+    PMLog::SetLevel(PMLog::kOff);
+    PMOutputManager::Instance()->SetFormat("none");
+    PMFastSimConfig::Instance()->SetEnabled(options.fastsim == "on");
+    PMStackingConfig::Instance()->SetLazyScintillation(options.stack == "lazy");
+    PMSetup::ConfigureShard(0, 1, options.seed);
+
+    PMOpticalResponse* response = PMOpticalResponse::Instance();
+    if (options.optical == "on") {
+        response->SetMode(PMOpticalResponse::kFull);
+    } else {
+        response->SetMode(PMOpticalResponse::ParseMode(options.optical));
+    }
+
+    PMSetup::SetUserInitializations(runManager, options.physics, "", options.energy * MeV);
+
+    G4UImanager* UImanager = G4UImanager::GetUIpointer();
+    UImanager->ApplyCommand("/control/verbose 0");
+    UImanager->ApplyCommand("/run/verbose 0");
+    UImanager->ApplyCommand("/event/verbose 0");
+    UImanager->ApplyCommand("/tracking/verbose 0");
+    UImanager->ApplyCommand("/tracking/storeTrajectory 0");
+
+    auto initStart = std::chrono::steady_clock::now();
+    runManager->Initialize();
+    G4double initSeconds = SecondsSince(initStart);
+
+    // The run timer includes physics table building, which happens at the
+    // start of the first BeamOn; the run action's own timer excludes it.
+    auto runStart = std::chrono::steady_clock::now();
+    runManager->BeamOn(options.nEvents);
+    G4double beamOnSeconds = SecondsSince(runStart);
+
+    const auto* runAction = static_cast<const PMRunAction*>(runManager->GetUserRunAction());
+    const PMRunAction::RunTotals& totals = runAction->GetLastRunTotals();
+    const G4double eventSeconds = totals.seconds > 0. ? totals.seconds : beamOnSeconds;
+
+    std::FILE* out = options.jsonFile.empty() ? stdout : std::fopen(options.jsonFile.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "sim_bench: cannot open %s\n", options.jsonFile.c_str());
+        return 1;
+    }
+    std::fprintf(out,
+                 "{\"geant4\": \"%s\", \"physics\": \"%s\", \"fastsim\": \"%s\", \"stack\": \"%s\", "
+                 "\"energy_MeV\": %.6g, "
+                 "\"optical\": \"%s\", \"threads\": %d, \"events\": %d, \"seed\": %ld, "
+                 "\"init_s\": %.6g, \"beamon_s\": %.6g, \"event_loop_s\": %.6g, "
+                 "\"total_s\": %.6g, \"events_per_s\": %.6g, \"steps_per_s\": %.6g, "
+                 "\"optical_photons_per_s\": %.6g, \"steps\": %ld, \"optical_photons\": %ld, "
+                 "\"aluminum_photons\": %ld, \"aluminum_weight\": %.6g, \"edep_MeV_per_event\": %.6g, "
+                 "\"peak_rss_kB\": %ld",
+                 G4Version.c_str(), options.physics.c_str(), options.fastsim.c_str(), options.stack.c_str(),
+                 options.energy,
+                 options.optical.c_str(), runManager->GetNumberOfThreads(), totals.events,
+                 options.seed, initSeconds, beamOnSeconds, eventSeconds,
+                 SecondsSince(processStart), totals.events / eventSeconds,
+                 totals.steps / eventSeconds, totals.opticalPhotons / eventSeconds,
+                 static_cast<long>(totals.steps), static_cast<long>(totals.opticalPhotons),
+                 static_cast<long>(totals.aluminumPhotons),
+                 totals.aluminumWeight,
+                 totals.events > 0 ? totals.energyDeposit / MeV / totals.events : 0.,
+                 PeakRSSKilobytes());
+    // PM_ALLOC_COUNTING builds only: heap allocations per event by callback.
+    if (PMAllocCounter::IsCompiledIn()) {
+        const PMAllocCounter::Totals& allocs = PMAllocCounter::Instance()->GetLastRun();
+        const G4double events = allocs.events > 0 ? allocs.events : 1;
+        std::fprintf(out, ", \"allocations_per_event\": {");
+        for (G4int s = 0; s < PMAllocCounter::kScopes; ++s) {
+            std::fprintf(out, "%s\"%s\": {\"count\": %.6g, \"bytes\": %.6g, \"max_count\": %ld}",
+                         s ? ", " : "", PMAllocCounter::GetScopeName(s), allocs.allocations[s] / events,
+                         allocs.bytes[s] / events, static_cast<long>(allocs.maxEventAllocations[s]));
+        }
+        std::fprintf(out, "}");
+    }
+    std::fprintf(out, "}\n");
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    delete runManager;
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Per-step cost of volume classification: the old name-based checks against
+// the PMVolumeRegistry pointer lookup, over the detector's real volume set.
+//
+//   ./step_classify_bench [iterations]
+
+#include "PMVolumeRegistry.hh"
+#include "G4Box.hh"
+#include "G4LogicalVolume.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+template <typename F>
+double NanosecondsPerCall(const std::vector<G4VPhysicalVolume*>& steps, F&& classify, G4int& hits) {
+    auto start = std::chrono::steady_clock::now();
+    for (G4VPhysicalVolume* volume : steps) {
+        hits += classify(volume);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / steps.size();
+}
+}
+
+int main(int argc, char** argv) {
+    std::size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20000000;
+
+    G4Material* air = G4NistManager::Instance()->FindOrBuildMaterial("G4_AIR");
+    auto* box = new G4Box("Box", 1 * cm, 1 * cm, 1 * cm);
+    auto* worldLV = new G4LogicalVolume(new G4Box("World", 1 * m, 1 * m, 1 * m), air, "World");
+    auto* worldPhys = new G4PVPlacement(nullptr, G4ThreeVector(), worldLV, "World", nullptr, false, 0);
+
+    PMVolumeRegistry* registry = PMVolumeRegistry::Instance();
+    registry->Register(worldLV, PMVolumeID::kWorld);
+
+    struct Entry { const char* name; PMVolumeID id; };
+    const Entry entries[] = {
+        {"ScintillatorPhys", PMVolumeID::kScintillator},
+        {"TeflonY_Front", PMVolumeID::kTeflon}, {"TeflonY_Back", PMVolumeID::kTeflon},
+        {"TeflonX_Left", PMVolumeID::kTeflon},  {"TeflonX_Right", PMVolumeID::kTeflon},
+        {"TeflonTop", PMVolumeID::kTeflon},     {"AluminumPlate", PMVolumeID::kAluminum},
+    };
+
+    std::vector<G4VPhysicalVolume*> volumes = {worldPhys};
+    G4int copy = 0;
+    for (const Entry& entry : entries) {
+        auto* logical = new G4LogicalVolume(box, air, entry.name);
+        registry->Register(logical, entry.id);
+        volumes.push_back(new G4PVPlacement(nullptr, G4ThreeVector(copy * 3 * cm, 0, 0),
+                                            logical, entry.name, worldLV, false, copy));
+        ++copy;
+    }
+
+    // Optical photons spend most steps in the crystal; weight it accordingly.
+    std::mt19937 rng(12345);
+    std::discrete_distribution<G4int> pick({1, 80, 2, 2, 2, 2, 2, 9});
+    std::vector<G4VPhysicalVolume*> steps(iterations);
+    for (auto& volume : steps) {
+        volume = volumes[pick(rng)];
+    }
+
+    G4int hits = 0;
+    double byName = NanosecondsPerCall(steps, [](G4VPhysicalVolume* volume) {
+        G4String volName = volume->GetName();
+        return G4int(volName == "AluminumPlate" || volName == "AluminumSurface" || volName == "AluminumPhys");
+    }, hits);
+
+    double byPointer = NanosecondsPerCall(steps, [registry](G4VPhysicalVolume* volume) {
+        return G4int(registry->Classify(volume) == PMVolumeID::kAluminum);
+    }, hits);
+
+    G4cout << "steps: " << iterations << " (checksum " << hits << ")\n"
+           << "name compare:     " << byName << " ns/step\n"
+           << "registry lookup:  " << byPointer << " ns/step\n"
+           << "speedup:          " << byName / byPointer << "x" << G4endl;
+    return 0;
+}
@@ -0,0 +1,89 @@
+#ifndef PMALLOCCOUNTER_HH
+#define PMALLOCCOUNTER_HH
+
+#include "G4Threading.hh"
+#include "globals.hh"
+
+// User callbacks that allocations are charged to; everything outside them
+// (tracking, processes, event bookkeeping) counts as kGeant4.
+enum class PMAllocScope : G4int {
+    kGeant4 = 0,
+    kPrimary,
+    kStepping,
+    kStacking,
+    kSensitive,
+    kEvent,
+    kDigitizer,
+    kCount
+};
+
+// Heap allocation accounting for the PM_ALLOC_COUNTING build
+// (-DPM_ALLOC_COUNTING=ON). That build replaces the global operator new
+// and charges every allocation and its size to the innermost
+// PM_ALLOC_SCOPE on the calling thread. Each thread closes an event
+// window at the end of its EndOfEventAction, so the kernel's work between
+// two events belongs to the second one. Totals are merged by the master
+// at the end of the run like the step profile.
+//
+// Without the option the scopes expand to nothing and the counters stay
+// at zero.
+class PMAllocCounter {
+public:
+    static constexpr G4int kScopes = static_cast<G4int>(PMAllocScope::kCount);
+
+    struct Totals {
+        G4int events = 0;
+        G4long allocations[kScopes] = {};
+        G4long bytes[kScopes] = {};
+        G4long maxEventAllocations[kScopes] = {};  // worst single event
+    };
+
+    class Scope {
+    public:
+        explicit Scope(PMAllocScope scope) : fPrevious(Enter(scope)) {}
+        ~Scope() { Leave(fPrevious); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        G4int fPrevious;
+    };
+
+    static PMAllocCounter* Instance();
+    static constexpr G4bool IsCompiledIn() {
+#ifdef PM_ALLOC_COUNTING
+        return true;
+#else
+        return false;
+#endif
+    }
+    static const char* GetScopeName(G4int scope);
+
+    // Master only.
+    void BeginOfRun();
+    void EndOfRun();
+
+    void BeginOfThreadRun();
+    static void EndOfEvent();
+    void MergeThreadTotals();
+
+    // Merged totals of the last completed run (master only).
+    const Totals& GetLastRun() const { return fMerged; }
+
+private:
+    PMAllocCounter();
+
+    static G4int Enter(PMAllocScope scope);
+    static void Leave(G4int previous);
+
+    Totals fMerged;
+    G4Mutex fMergeMutex;
+};
+
+#ifdef PM_ALLOC_COUNTING
+#define PM_ALLOC_SCOPE(scope) PMAllocCounter::Scope pmAllocScope_(PMAllocScope::scope)
+#else
+#define PM_ALLOC_SCOPE(scope) do {} while (0)
+#endif
+
+#endif
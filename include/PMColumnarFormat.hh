@@ -0,0 +1,63 @@
+#ifndef PMCOLUMNARFORMAT_HH
+#define PMCOLUMNARFORMAT_HH
+
+// On-disk layout of the .pmc columnar output, shared by PMColumnarWriter and
+// the standalone pmc_tool (which does not link Geant4, hence plain types).
+//
+//   FileHeader
+//   ColumnDesc[nColumns]
+//   { ChunkHeader, ColumnBlock[nColumns], column payloads } ...
+//
+// Each payload holds one column of the chunk's rows, either raw
+// (little-endian, contiguous, mmap-able) or zlib-compressed, padded to 8
+// bytes. Chunks are self-contained, so files from several workers can be
+// read back to back or concatenated without decoding.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PMColumnar {
+
+constexpr char kFileMagic[8] = {'P', 'M', 'C', 'O', 'L', '0', '0', '1'};
+constexpr std::uint32_t kChunkMagic = 0x4b4e4843;  // "CHNK"
+constexpr std::size_t kNameLength = 32;
+constexpr std::size_t kAlignment = 8;
+
+enum ColumnType : std::uint8_t { kInt32 = 0, kFloat64 = 1 };
+enum Codec : std::uint32_t { kRaw = 0, kZlib = 1 };
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t nColumns;
+    std::uint32_t reserved;
+};
+
+struct ColumnDesc {
+    char name[kNameLength];
+    std::uint8_t type;
+    std::uint8_t reserved[7];
+};
+
+struct ChunkHeader {
+    std::uint32_t magic;
+    std::uint32_t nRows;
+    std::uint32_t codec;
+    std::uint32_t nColumns;
+};
+
+struct ColumnBlock {
+    std::uint64_t rawBytes;
+    std::uint64_t storedBytes;
+};
+
+inline std::size_t TypeSize(std::uint8_t type) {
+    return (type == kInt32) ? 4 : 8;
+}
+
+inline std::size_t Padded(std::size_t bytes) {
+    return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+}  // namespace PMColumnar
+
+#endif
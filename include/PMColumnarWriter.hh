@@ -0,0 +1,69 @@
+#ifndef PMCOLUMNARWRITER_HH
+#define PMCOLUMNARWRITER_HH
+
+#include "PMColumnarFormat.hh"
+#include "PMSpscQueue.hh"
+#include "globals.hh"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Streams rows into a .pmc file (see PMColumnarFormat.hh). The owning
+// thread fills rows into the current chunk; full chunks go through a
+// lock-free queue to a writer thread that compresses and writes them, then
+// returns the chunk for reuse. Steady-state filling neither locks nor
+// allocates.
+class PMColumnarWriter {
+public:
+    PMColumnarWriter();
+    ~PMColumnarWriter();
+
+    // Columns are declared before Open().
+    G4int AddColumn(const G4String& name, PMColumnar::ColumnType type);
+
+    G4bool Open(const G4String& fileName, G4int rowsPerChunk, G4bool compress);
+    void Close();
+    G4bool IsOpen() const { return fFile != nullptr; }
+
+    void Fill(G4int column, G4int value) { Store(column, &value, sizeof(value)); }
+    void Fill(G4int column, G4double value) { Store(column, &value, sizeof(value)); }
+    void AddRow();
+
+private:
+    struct Chunk {
+        G4int nRows = 0;
+        std::vector<std::vector<char>> columns;
+    };
+
+    static constexpr std::size_t kQueueSize = 16;
+    static constexpr G4int kChunkPool = 8;
+
+    void Store(G4int column, const void* value, std::size_t size);
+    void Submit(Chunk* chunk);
+    Chunk* Acquire();
+    void WriterLoop();
+    void WriteChunk(const Chunk& chunk);
+    // Fills fCompressBuffer and blocks; false if zlib failed on a column.
+    G4bool StageChunk(const Chunk& chunk, std::vector<PMColumnar::ColumnBlock>& blocks,
+                      std::size_t& staged);
+
+    std::vector<PMColumnar::ColumnDesc> fColumns;
+    std::vector<Chunk> fPool;
+    Chunk* fCurrent;
+
+    PMSpscQueue<Chunk*, kQueueSize> fFull;
+    PMSpscQueue<Chunk*, kQueueSize> fFree;
+    std::thread fThread;
+    std::atomic<bool> fStop;
+
+    std::FILE* fFile;
+    G4int fRowsPerChunk;
+    G4bool fCompress;
+
+    // Writer thread only.
+    std::vector<unsigned char> fCompressBuffer;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef PMCOMMANDLINE_HH
+#define PMCOMMANDLINE_HH
+
+#include "globals.hh"
+
+// Options shared by the executables. Everything not given on the command
+// line falls back to the PM_* environment variables, then to defaults.
+//
+//   sim [macro] [-t|--threads N] [-p|--physics full|lean] [--table-cache DIR]
+//       [--seed S] [--shard i/N]
+//   sim_batch [macro] [-n|--events N] [same options]
+//
+//   PM_NUM_THREADS   worker thread count (0 = all cores)
+//   PM_PHYSICS       physics list configuration (see PMPhysicsList)
+//   PM_TABLE_CACHE   physics table cache directory (empty = no cache)
+//   PM_SEED          master seed for per-event reseeding (0 = off)
+//   PM_SHARD         shard of a multi-process run (see PMShard)
+struct PMCommandLine {
+    G4String macroFile;
+    G4int nThreads = 0;
+    G4String physics = "full";
+    G4String tableCache;
+    G4long seed = 0;
+    G4int shardIndex = 0;
+    G4int shardCount = 1;
+    G4int nEvents = 0;  // sim_batch: events to run after the macro
+
+    static PMCommandLine Parse(int argc, char** argv);
+    static void PrintUsage(const char* program);
+};
+
+#endif
@@ -4,8 +4,14 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "G4LogicalVolume.hh"
 #include "G4Material.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
 
 class G4VPhysicalVolume;
+class G4MaterialPropertiesTable;
+class PMDetectorMessenger;
+class PMFastScintillatorModel;
 
 class PMDetectorConstruction : public G4VUserDetectorConstruction {
 public:
@@ -15,6 +21,35 @@ public:
     virtual G4VPhysicalVolume* Construct();
     void ConstructSDandField();
 
+    // One module (crystal, five Teflon walls, aluminum window in the hole)
+    // is built once and placed nx x ny times in the world, copy number
+    // iy * nx + ix, centred on the beam axis. The world grows to fit.
+    //
+    // The crystals form the ScintillatorRegion, the envelope of the
+    // parametrized response (PMFastScintillatorModel, /PM/fastsim/).
+    //
+    // Geometry setters trigger a geometry rebuild before the next run;
+    // the reflectivity is updated in place.
+    void SetScintillatorSize(const G4ThreeVector& size);
+    void SetTeflonThickness(G4double thickness);
+    void SetHoleSize(G4double size);
+    void SetTeflonReflectivity(G4double reflectivity);
+    void SetAluminumThickness(G4double thickness);
+    void SetWorldSize(G4double size);
+    void SetArraySize(G4int nx, G4int ny);
+    void SetModuleGap(G4double gap);
+
+    const G4ThreeVector& GetScintillatorSize() const { return fScintillatorSize; }
+    G4double GetTeflonThickness() const { return fTeflonThickness; }
+    G4double GetHoleSize() const { return fHoleSize; }
+    G4double GetTeflonReflectivity() const { return fTeflonReflectivity; }
+    // 0 selects 1.2 x the Teflon thickness.
+    G4double GetAluminumThickness() const { return fAluminumThickness; }
+    G4double GetWorldSize() const { return fWorldSize; }
+    G4int GetArrayNx() const { return fArrayNx; }
+    G4int GetArrayNy() const { return fArrayNy; }
+    G4double GetModuleGap() const { return fModuleGap; }
+
     private:
     G4Material* CreateScintillatorMaterial();
     G4Material* CreateTeflonMaterial();
@@ -25,6 +60,7 @@ public:
                                 G4VPhysicalVolume* teflonTopPhys, G4VPhysicalVolume* teflonBackPhys,
                                 G4VPhysicalVolume* teflonFrontPhys);
 
+    G4LogicalVolume* moduleLogical;
     G4LogicalVolume* scintillatorLogical;
     G4LogicalVolume* aluminumLogical;
     G4VPhysicalVolume* aluminumPhys;
@@ -38,6 +74,21 @@ public:
     G4VPhysicalVolume* teflonFrontPhys;
     G4VPhysicalVolume* teflonBackPhys;
     G4VPhysicalVolume* teflonTopPhys;
+
+    G4ThreeVector fScintillatorSize;
+    G4double fTeflonThickness;
+    G4double fHoleSize;
+    G4double fTeflonReflectivity;
+    G4double fAluminumThickness;
+    G4double fWorldSize;
+    G4int fArrayNx, fArrayNy;
+    G4double fModuleGap;
+    G4MaterialPropertiesTable* fTeflonSurfaceMPT;
+    std::vector<G4double> fTeflonEnergies;
+
+    PMDetectorMessenger* fMessenger;
+
+    static G4ThreadLocal PMFastScintillatorModel* fFastModel;
 };
 
 #endif
@@ -0,0 +1,35 @@
+#ifndef PMDETECTORMESSENGER_HH
+#define PMDETECTORMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class PMDetectorConstruction;
+class G4UIdirectory;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWith3VectorAndUnit;
+class G4UIcommand;
+
+class PMDetectorMessenger : public G4UImessenger {
+public:
+    explicit PMDetectorMessenger(PMDetectorConstruction* detector);
+    ~PMDetectorMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    PMDetectorConstruction* fDetector;
+
+    G4UIdirectory* fDirectory;
+    G4UIcmdWith3VectorAndUnit* fScintSizeCmd;
+    G4UIcmdWithADoubleAndUnit* fTeflonThicknessCmd;
+    G4UIcmdWithADoubleAndUnit* fHoleSizeCmd;
+    G4UIcmdWithADouble* fReflectivityCmd;
+    G4UIcmdWithADoubleAndUnit* fAluminumThicknessCmd;
+    G4UIcmdWithADoubleAndUnit* fWorldSizeCmd;
+    G4UIcommand* fArrayCmd;
+    G4UIcmdWithADoubleAndUnit* fModuleGapCmd;
+};
+
+#endif
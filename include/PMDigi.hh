@@ -0,0 +1,51 @@
+#ifndef PMDIGI_HH
+#define PMDIGI_HH
+
+#include "G4VDigi.hh"
+#include "G4TDigiCollection.hh"
+#include "G4Allocator.hh"
+#include "globals.hh"
+
+// Pulse features of one module's digitized waveform in one event.
+// Amplitudes are in units of the single-photoelectron peak height, the
+// integral in photoelectrons, the time is the constant-fraction crossing.
+class PMDigi : public G4VDigi {
+public:
+    PMDigi(G4int module, G4double photoelectrons, G4double amplitude, G4double integral, G4double time)
+        : fModule(module), fPhotoelectrons(photoelectrons), fAmplitude(amplitude),
+          fIntegral(integral), fTime(time) {}
+    ~PMDigi() override = default;
+
+    inline void* operator new(size_t);
+    inline void operator delete(void* digi);
+
+    G4int GetModule() const { return fModule; }
+    G4double GetPhotoelectrons() const { return fPhotoelectrons; }
+    G4double GetAmplitude() const { return fAmplitude; }
+    G4double GetIntegral() const { return fIntegral; }
+    G4double GetTime() const { return fTime; }
+
+private:
+    G4int fModule;
+    G4double fPhotoelectrons;  // true (weighted) photoelectron count
+    G4double fAmplitude;
+    G4double fIntegral;
+    G4double fTime;
+};
+
+using PMDigiCollection = G4TDigiCollection<PMDigi>;
+
+extern G4ThreadLocal G4Allocator<PMDigi>* PMDigiAllocator;
+
+inline void* PMDigi::operator new(size_t) {
+    if (!PMDigiAllocator) {
+        PMDigiAllocator = new G4Allocator<PMDigi>;
+    }
+    return PMDigiAllocator->MallocSingle();
+}
+
+inline void PMDigi::operator delete(void* digi) {
+    PMDigiAllocator->FreeSingle(static_cast<PMDigi*>(digi));
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef PMDIGITIZER_HH
+#define PMDIGITIZER_HH
+
+#include "G4VDigitizerModule.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class PMDigitizerMessenger;
+
+// Readout parameters shared by the digitizers of all threads (/PM/digi/).
+// Times in Geant4 units; amplitudes in single-photoelectron peak heights.
+class PMDigitizerConfig {
+public:
+    static PMDigitizerConfig* Instance();
+
+    G4bool IsEnabled() const { return fEnabled; }
+    void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+    G4double GetQuantumEfficiency() const { return fQuantumEfficiency; }
+    void SetQuantumEfficiency(G4double qe) { fQuantumEfficiency = qe; }
+    G4double GetSPEResolution() const { return fSPEResolution; }
+    void SetSPEResolution(G4double sigma) { fSPEResolution = sigma; }
+    G4double GetDecayTime() const { return fDecayTime; }
+    void SetDecayTime(G4double time) { fDecayTime = time; }
+    G4double GetRiseTime() const { return fRiseTime; }
+    void SetRiseTime(G4double time) { fRiseTime = time; }
+    G4double GetFallTime() const { return fFallTime; }
+    void SetFallTime(G4double time) { fFallTime = time; }
+    G4double GetNoise() const { return fNoise; }
+    void SetNoise(G4double sigma) { fNoise = sigma; }
+    G4double GetSamplePeriod() const { return fSamplePeriod; }
+    void SetSamplePeriod(G4double period) { fSamplePeriod = period; }
+    G4double GetWindow() const { return fWindow; }
+    void SetWindow(G4double window) { fWindow = window; }
+    G4double GetCFDFraction() const { return fCFDFraction; }
+    void SetCFDFraction(G4double fraction) { fCFDFraction = fraction; }
+
+private:
+    PMDigitizerConfig();
+
+    G4bool fEnabled;
+    G4double fQuantumEfficiency;
+    G4double fSPEResolution;   // sigma/mean of the single-photoelectron charge
+    G4double fDecayTime;       // scintillation delay added per photoelectron, 0 = none
+    G4double fRiseTime;        // single-photoelectron pulse shape
+    G4double fFallTime;
+    G4double fNoise;           // Gaussian sigma per sample
+    G4double fSamplePeriod;
+    G4double fWindow;          // from t = 0, the primary vertex time
+    G4double fCFDFraction;
+    PMDigitizerMessenger* fMessenger;
+};
+
+// Turns the "ModuleSD/photons" hits of an event into one sampled waveform
+// per module and stores its pulse features in "PMDigitizer/digis".
+//
+// Each detected photon is converted with the quantum efficiency, optionally
+// delayed (/PM/digi/decayTime; hits already carry the material's decay)
+// and given a Gaussian single-photoelectron charge. The
+// charges are binned into samples first, so the cost of the pulse
+// superposition does not grow with the number of photoelectrons: every
+// non-empty bin adds one copy of the pulse kernel, a contiguous
+// multiply-add that the compiler turns into SIMD code. Buffers are kept
+// across events.
+class PMDigitizer : public G4VDigitizerModule {
+public:
+    explicit PMDigitizer(const G4String& name = "PMDigitizer");
+    ~PMDigitizer() override = default;
+
+    void Digitize() override;
+
+    // The waveform of the last module digitized (for inspection).
+    const std::vector<float>& GetWaveform() const { return fWaveform; }
+
+private:
+    void Configure(G4int nModules);
+
+    G4int fPhotonCollectionID;
+    G4int fSamples;
+    G4double fSamplePeriod;
+    G4double fRiseTime;
+    G4double fFallTime;
+    std::vector<float> fKernel;       // single-photoelectron pulse, peak 1
+    G4double fKernelSum;
+    std::vector<float> fCharge;       // [module][sample] photoelectron charge
+    std::vector<G4double> fPhotoelectrons;
+    std::vector<float> fWaveform;
+};
+
+#endif
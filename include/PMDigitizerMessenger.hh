@@ -0,0 +1,36 @@
+#ifndef PMDIGITIZERMESSENGER_HH
+#define PMDIGITIZERMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class PMDigitizerConfig;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+
+class PMDigitizerMessenger : public G4UImessenger {
+public:
+    explicit PMDigitizerMessenger(PMDigitizerConfig* config);
+    ~PMDigitizerMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    PMDigitizerConfig* fConfig;
+
+    G4UIdirectory* fDirectory;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWithADouble* fQECmd;
+    G4UIcmdWithADouble* fSPECmd;
+    G4UIcmdWithADoubleAndUnit* fDecayCmd;
+    G4UIcmdWithADoubleAndUnit* fRiseCmd;
+    G4UIcmdWithADoubleAndUnit* fFallCmd;
+    G4UIcmdWithADouble* fNoiseCmd;
+    G4UIcmdWithADoubleAndUnit* fSampleCmd;
+    G4UIcmdWithADoubleAndUnit* fWindowCmd;
+    G4UIcmdWithADouble* fCFDCmd;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef PMEMISSIONSPECTRUM_HH
+#define PMEMISSIONSPECTRUM_HH
+
+#include "globals.hh"
+
+#include <vector>
+
+class G4Material;
+
+// Photon-energy sampler for a scintillation emission spectrum given as
+// intensities at increasing energies (linear in between). The inverse CDF
+// is tabulated at kTableSize + 1 equiprobable points when the material is
+// built; a sample is one table lookup and a linear interpolation,
+// whatever the number of spectrum points.
+//
+// Tables are built on the master in Construct and only read by workers.
+class PMEmissionSpectrum {
+public:
+    static constexpr G4int kTableSize = 1024;
+
+    PMEmissionSpectrum(const std::vector<G4double>& energies, const std::vector<G4double>& intensities);
+
+    // u uniform in [0, 1).
+    G4double Sample(G4double u) const {
+        const G4double x = u * kTableSize;
+        G4int i = static_cast<G4int>(x);
+        if (i >= kTableSize) i = kTableSize - 1;
+        return fInverseCDF[i] + (x - i) * (fInverseCDF[i + 1] - fInverseCDF[i]);
+    }
+    G4double GetMeanEnergy() const { return fMeanEnergy; }
+
+    // Registry by material; Build replaces an existing entry (master only,
+    // between runs).
+    static const PMEmissionSpectrum* Build(const G4Material* material, const std::vector<G4double>& energies,
+                                           const std::vector<G4double>& intensities);
+    static const PMEmissionSpectrum* Find(const G4Material* material);
+
+private:
+    std::vector<G4double> fInverseCDF;
+    G4double fMeanEnergy;
+};
+
+#endif
@@ -7,10 +7,13 @@
 #include "globals.hh"        
 
 class G4Event;
+class PMRunAction;
+class PMPhotonRecordBuffer;
+class PMHistogramSet;
 
 class PMEventAction : public G4UserEventAction {
 public:
-    PMEventAction();
+    explicit PMEventAction(PMRunAction* runAction);
     virtual ~PMEventAction();
 
     virtual void BeginOfEventAction(const G4Event*);
@@ -18,18 +21,36 @@ public:
     
     void AddOpticalPhoton();
     void AddGammaToTeflon();
-    void AddAluminumPhoton();  
+    // Fast optical mode only: photons resolved by the light-collection map
+    // at birth never reach the sensitive detector. Tracked photons are
+    // counted from the ModuleSD hit collections.
+    void AddAluminumPhoton(G4double weight = 1.);
     void AddScintillationPhoton();
-    void RecordEnergy(G4double energy);
+    void AddStep() { ++fStepCount; }
+
+    // Null unless per-photon records are enabled (/PM/output/photons).
+    PMPhotonRecordBuffer* GetPhotonRecords() const { return fPhotonRecords; }
 
 private:
+    PMRunAction* fRunAction;
+    PMHistogramSet* fHistograms;
+    PMPhotonRecordBuffer* fPhotonRecords;
     G4int fOpticalPhotonCount;
     G4int fGammaTeflonCount;
     G4int fAluminumPhotonCount;
-    G4int fPhotonsAtAluminumBoundary;  
+    G4int fPhotonsAtAluminumBoundary;
+    G4double fAluminumWeight;
     G4int fScintillationCount;
     G4double fTotalEnergyDep;
-    std::vector<G4double> fEnergyDeposits;
+    G4long fStepCount;
+    G4int fEdepCollectionID;
+    G4int fPhotonCollectionID;
+    G4int fDigiCollectionID;
+    G4double fDigiCharge;   // photoelectrons, summed over modules
+    G4double fDigiTime;     // earliest module pulse time, -1 without a pulse
+
+    void ReadHits(const G4Event* event);
+    void ReadDigis();
 };
 
 #endif
@@ -0,0 +1,61 @@
+#ifndef PMFASTSCINTILLATORMODEL_HH
+#define PMFASTSCINTILLATORMODEL_HH
+
+#include "G4VFastSimulationModel.hh"
+#include "globals.hh"
+
+class G4FastSimHitMaker;
+class PMFastSimMessenger;
+
+// Run-level switch and parameters of the parametrized crystal response,
+// shared by all threads (/PM/fastsim/). Read at every trigger, so full and
+// fast runs can alternate in one job.
+class PMFastSimConfig {
+public:
+    static PMFastSimConfig* Instance();
+
+    G4bool IsEnabled() const { return fEnabled; }
+    void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+    G4double GetMaxEnergy() const { return fMaxEnergy; }
+    void SetMaxEnergy(G4double energy) { fMaxEnergy = energy; }
+    // Used when no light-collection map is loaded (/PM/optical/mode fast).
+    G4double GetLightCollection() const { return fLightCollection; }
+    void SetLightCollection(G4double efficiency) { fLightCollection = efficiency; }
+
+private:
+    PMFastSimConfig();
+
+    G4bool fEnabled;
+    G4double fMaxEnergy;
+    G4double fLightCollection;
+    PMFastSimMessenger* fMessenger;
+};
+
+// Attached to the ScintillatorRegion (the NaI crystals). An electron below
+// the maximum energy that enters or is created in a crystal is stopped at
+// once: its kinetic energy is spread in equal parts along its direction
+// over the mean projected range and handed to the module's sensitive
+// detector through G4FastSimHitMaker. PMSensitiveDetector turns each fast
+// hit into light statistically, so neither the electron nor its optical
+// photons are tracked. Gammas keep full transport.
+class PMFastScintillatorModel : public G4VFastSimulationModel {
+public:
+    PMFastScintillatorModel(const G4String& name, G4Region* region);
+    ~PMFastScintillatorModel() override;
+
+    G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+    G4bool ModelTrigger(const G4FastTrack& fastTrack) override;
+    void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) override;
+
+    // The hit maker's navigator is bound to the world it first saw; call
+    // after every geometry rebuild.
+    void ResetHitMaker();
+
+    // Katz-Penfold CSDA range of an electron, in mass thickness.
+    static G4double ElectronRange(G4double kineticEnergy);
+
+private:
+    G4FastSimHitMaker* fHitMaker;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef PMFASTSIMMESSENGER_HH
+#define PMFASTSIMMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class PMFastSimConfig;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+
+class PMFastSimMessenger : public G4UImessenger {
+public:
+    explicit PMFastSimMessenger(PMFastSimConfig* config);
+    ~PMFastSimMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    PMFastSimConfig* fConfig;
+
+    G4UIdirectory* fDirectory;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWithADoubleAndUnit* fMaxEnergyCmd;
+    G4UIcmdWithADouble* fLightCollectionCmd;
+};
+
+#endif
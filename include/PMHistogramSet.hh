@@ -0,0 +1,85 @@
+#ifndef PMHISTOGRAMSET_HH
+#define PMHISTOGRAMSET_HH
+
+#include "globals.hh"
+
+// Histogram IDs are fixed at compile time; the booking table in
+// PMHistogramSet.cc gives each one its name and binning, in this order.
+enum class PMHistID : G4int {
+    kEdep = 0,        // energy deposit in NaI per event [MeV]
+    kEdepFine,        // same, 16k bins for peak shapes
+    kOptical,         // optical photons created per event
+    kScintillation,   // scintillation photons per event
+    kAluminum,        // photons reaching the aluminum window per event
+    kGammaTeflon,     // gammas entering the Teflon barrier per event
+    kCount
+};
+
+struct PMHistogramDef {
+    const char* name;
+    const char* title;
+    G4int nBins;
+    G4double min;
+    G4double max;
+};
+
+// Fixed-bin 1D histograms for one thread, kept in a single 64-byte aligned
+// buffer (underflow, bins, overflow per histogram, each padded to a cache
+// line). Every worker fills its own set without locks; at the end of the
+// run the master sums the registered worker sets in thread-ID order, so
+// the merged contents do not depend on which worker finished first.
+class PMHistogramSet {
+public:
+    PMHistogramSet();
+    ~PMHistogramSet();
+
+    PMHistogramSet(const PMHistogramSet&) = delete;
+    PMHistogramSet& operator=(const PMHistogramSet&) = delete;
+
+    static const PMHistogramDef& GetDef(PMHistID id);
+
+    void Fill(PMHistID id, G4double x, G4double weight = 1.) {
+        const G4int h = static_cast<G4int>(id);
+        G4double* slots = fData + fOffset[h];
+        const G4double u = (x - fMin[h]) * fInvWidth[h];
+        G4int slot;
+        if (u < 0.) {
+            slot = 0;
+        } else if (!(u < fNBins[h])) {
+            slot = fNBins[h] + 1;
+        } else {
+            slot = 1 + static_cast<G4int>(u);
+        }
+        slots[slot] += weight;
+    }
+
+    // Slot 0 is the underflow, nBins + 1 the overflow.
+    G4double GetSlot(PMHistID id, G4int slot) const {
+        return fData[fOffset[static_cast<G4int>(id)] + slot];
+    }
+
+    void Reset();
+    void Add(const PMHistogramSet& other);
+
+    // Text dump: one header line per histogram followed by its slots,
+    // printed with %.17g so that files round-trip exactly.
+    G4bool Write(const G4String& fileName) const;
+
+    // Worker sets register at BeginOfRun; the master clears the list
+    // before the workers start and merges it after they have finished.
+    static void ClearThreadSets();
+    static void RegisterThreadSet(G4int threadId, const PMHistogramSet* set);
+    void MergeThreadSets();
+
+private:
+    static constexpr G4int kNumHistograms = static_cast<G4int>(PMHistID::kCount);
+
+    G4double* fData;
+    std::size_t fSize;
+    std::size_t fOffset[kNumHistograms];
+    G4int fNBins[kNumHistograms];
+    G4double fMin[kNumHistograms];
+    G4double fInvWidth[kNumHistograms];
+};
+
+#endif
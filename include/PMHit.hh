@@ -0,0 +1,53 @@
+#ifndef PMHIT_HH
+#define PMHIT_HH
+
+#include "G4VHit.hh"
+#include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
+#include "globals.hh"
+
+// One readout record of the module sensitive detector. The "edep"
+// collection holds one hit per module that saw energy in its crystal
+// (energy summed, time of the first deposit); the "photons" collection
+// holds one hit per optical photon detected at a module's aluminum window
+// (photon energy, arrival time, track weight). Hits come from a per-thread
+// G4Allocator pool, so steady-state events do not touch the heap.
+class PMHit : public G4VHit {
+public:
+    PMHit(G4int module, G4double energy, G4double time, G4double weight = 1.)
+        : fModule(module), fEnergy(energy), fTime(time), fWeight(weight) {}
+    ~PMHit() override = default;
+
+    inline void* operator new(size_t);
+    inline void operator delete(void* hit);
+
+    void AddEnergy(G4double energy) { fEnergy += energy; }
+
+    G4int GetModule() const { return fModule; }
+    G4double GetEnergy() const { return fEnergy; }
+    G4double GetTime() const { return fTime; }
+    G4double GetWeight() const { return fWeight; }
+
+private:
+    G4int fModule;      // module copy number, -1 outside the array
+    G4double fEnergy;
+    G4double fTime;
+    G4double fWeight;
+};
+
+using PMHitsCollection = G4THitsCollection<PMHit>;
+
+extern G4ThreadLocal G4Allocator<PMHit>* PMHitAllocator;
+
+inline void* PMHit::operator new(size_t) {
+    if (!PMHitAllocator) {
+        PMHitAllocator = new G4Allocator<PMHit>;
+    }
+    return PMHitAllocator->MallocSingle();
+}
+
+inline void PMHit::operator delete(void* hit) {
+    PMHitAllocator->FreeSingle(static_cast<PMHit*>(hit));
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef PMLIGHTCOLLECTIONMAP_HH
+#define PMLIGHTCOLLECTIONMAP_HH
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include <vector>
+
+// Light-collection efficiency of the aluminum window as a function of the
+// optical photon's emission point (voxelized over the crystal, in the
+// crystal frame) and wavelength. A calibration run fills emitted/detected
+// counts with full optical tracking; a fast run only looks up the ratio.
+class PMLightCollectionMap {
+public:
+    PMLightCollectionMap();
+
+    void Configure(const G4ThreeVector& halfSize, G4int nx, G4int ny, G4int nz,
+                   G4int nWavelength, G4double minWavelength, G4double maxWavelength);
+    void Reset();
+
+    // -1 when the point or wavelength falls outside the map.
+    G4int Index(const G4ThreeVector& position, G4double photonEnergy) const;
+
+    void AddEmitted(G4int index, G4double weight = 1.) { if (index >= 0) fEmitted[index] += weight; }
+    void AddDetected(G4int index, G4double weight = 1.) { if (index >= 0) fDetected[index] += weight; }
+    void Add(const PMLightCollectionMap& other);
+
+    // Requires UpdateEfficiency() after the counts change.
+    G4double Efficiency(G4int index) const {
+        return (index >= 0) ? fEfficiency[index] : fMeanEfficiency;
+    }
+    void UpdateEfficiency();
+
+    G4bool Save(const G4String& fileName) const;
+    G4bool Load(const G4String& fileName);
+
+    G4int GetNumberOfCells() const { return static_cast<G4int>(fEmitted.size()); }
+    G4double GetTotalEmitted() const;
+    G4double GetTotalDetected() const;
+    G4double GetMeanEfficiency() const { return fMeanEfficiency; }
+
+private:
+    G4ThreeVector fHalfSize;
+    G4int fNx, fNy, fNz, fNWavelength;
+    G4double fMinWavelength, fMaxWavelength;
+
+    std::vector<G4double> fEmitted;
+    std::vector<G4double> fDetected;
+    std::vector<G4float> fEfficiency;
+    G4double fMeanEfficiency;
+};
+
+#endif
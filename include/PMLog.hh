@@ -0,0 +1,76 @@
+#ifndef PMLOG_HH
+#define PMLOG_HH
+
+#include "globals.hh"
+#include <atomic>
+
+class PMLogMessenger;
+
+// Console verbosity shared by all threads.
+//   off      nothing but errors
+//   summary  initialization banners and run summaries
+//   debug    per-event summaries and geometry checks
+//   trace    per-step / per-photon output (hot paths)
+//
+// PM_LOG_MAX_LEVEL is fixed at build time: statements above it are removed
+// by the preprocessor, so trace output costs nothing in Release builds.
+// Below that ceiling the level is chosen at runtime with /PM/log/level.
+#ifndef PM_LOG_MAX_LEVEL
+#define PM_LOG_MAX_LEVEL 3
+#endif
+
+#ifndef PM_LOG_DEFAULT_LEVEL
+#define PM_LOG_DEFAULT_LEVEL 1
+#endif
+
+class PMLog {
+public:
+    enum Level { kOff = 0, kSummary = 1, kDebug = 2, kTrace = 3 };
+
+    static PMLog* Instance();
+
+    static G4bool IsEnabled(G4int level) {
+        return level <= fLevel.load(std::memory_order_relaxed);
+    }
+    static G4int GetLevel() { return fLevel.load(std::memory_order_relaxed); }
+    static void SetLevel(G4int level);
+
+    static G4int ParseLevel(const G4String& name);
+    static const char* LevelName(G4int level);
+
+private:
+    PMLog();
+    ~PMLog();
+
+    static std::atomic<G4int> fLevel;
+    PMLogMessenger* fMessenger;
+};
+
+#define PM_LOG_AT(level, expr)                                   \
+    do {                                                         \
+        if (PMLog::IsEnabled(level)) { G4cout << expr << G4endl; } \
+    } while (0)
+
+#if PM_LOG_MAX_LEVEL >= 1
+#define PM_SUMMARY(expr) PM_LOG_AT(PMLog::kSummary, expr)
+#else
+#define PM_SUMMARY(expr) do {} while (0)
+#endif
+
+#if PM_LOG_MAX_LEVEL >= 2
+#define PM_DEBUG(expr) PM_LOG_AT(PMLog::kDebug, expr)
+#define PM_DEBUG_ENABLED() PMLog::IsEnabled(PMLog::kDebug)
+#else
+#define PM_DEBUG(expr) do {} while (0)
+#define PM_DEBUG_ENABLED() false
+#endif
+
+#if PM_LOG_MAX_LEVEL >= 3
+#define PM_TRACE(expr) PM_LOG_AT(PMLog::kTrace, expr)
+#define PM_TRACE_ENABLED() PMLog::IsEnabled(PMLog::kTrace)
+#else
+#define PM_TRACE(expr) do {} while (0)
+#define PM_TRACE_ENABLED() false
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef PMLOGMESSENGER_HH
+#define PMLOGMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+
+class PMLogMessenger : public G4UImessenger {
+public:
+    PMLogMessenger();
+    ~PMLogMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    G4UIdirectory* fDirectory;
+    G4UIcmdWithAString* fLevelCmd;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef PMMATERIALDATA_HH
+#define PMMATERIALDATA_HH
+
+#include "globals.hh"
+
+#include <utility>
+#include <vector>
+
+class G4MaterialPropertiesTable;
+
+// Optical properties of one material or surface, read from a text file in
+// the data directory (PM_DATA_DIR, default ./data):
+//
+//   # comment
+//   columns energy:eV RINDEX ABSLENGTH:cm SCINTILLATIONCOMPONENT1
+//   1.5   1.65  800  0.02
+//   ...
+//   const SCINTILLATIONYIELD 100000 1/MeV
+//
+// The first column is the photon energy. Every row needs one value per
+// column, energies must increase strictly and no value may be negative;
+// anything else is fatal (PMMaterial002) and names the file and line.
+class PMMaterialData {
+public:
+    // fileName is relative to the data directory.
+    static PMMaterialData Load(const G4String& fileName);
+    static G4String GetDataDirectory();
+
+    const G4String& GetFileName() const { return fFileName; }
+    const std::vector<G4double>& GetEnergies() const { return fColumns.front(); }
+    G4bool HasProperty(const G4String& name) const { return FindColumn(name) >= 0; }
+    // Fatal (PMMaterial003) when the column is missing.
+    const std::vector<G4double>& GetProperty(const G4String& name) const;
+
+    // Adds every column and constant; creates the table when mpt is null.
+    G4MaterialPropertiesTable* FillPropertiesTable(G4MaterialPropertiesTable* mpt = nullptr) const;
+
+private:
+    PMMaterialData() = default;
+
+    G4int FindColumn(const G4String& name) const;
+
+    G4String fFileName;
+    std::vector<G4String> fNames;                 // fNames[0] is "energy"
+    std::vector<std::vector<G4double>> fColumns;  // in Geant4 units
+    std::vector<std::pair<G4String, G4double>> fConstants;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef PMMETRICS_HH
+#define PMMETRICS_HH
+
+#include "G4Threading.hh"
+#include "globals.hh"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class PMMetricsMessenger;
+
+// Live progress of the current run (/PM/metrics/). While a run is going,
+// a background thread of the master rewrites <file>.json and <file>.prom
+// (Prometheus text format) every interval. They hold events done and to
+// do, event, step and photon rates, ETA, mean energy deposit, events per
+// thread and resident memory; sharded runs add _shard<i> to the stem.
+// Each file is written under a temporary name and renamed, so readers
+// never see a partial file.
+//
+// Every worker owns one cache-line sized slot and is its only writer: the
+// end-of-event update is a few relaxed loads and stores with no locked
+// instruction, and the writer thread only reads. Nothing in the event loop
+// ever waits for the writer.
+class PMMetrics {
+public:
+    static constexpr G4int kMaxSlots = 512;
+
+    static PMMetrics* Instance();
+
+    G4bool IsEnabled() const { return fEnabled; }
+    void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+    G4double GetInterval() const { return fInterval; }
+    void SetInterval(G4double seconds) { fInterval = seconds; }
+    const G4String& GetFileName() const { return fFileName; }
+    void SetFileName(const G4String& fileName) { fFileName = fileName; }
+
+    // Master only: start and stop the writer thread.
+    void BeginOfRun(G4int runID, G4int eventsToProcess);
+    void EndOfRun();
+
+    void BeginOfThreadRun();
+
+    // Called by the event action at the end of every event.
+    static void AddEvent(G4int opticalPhotons, G4double edep, G4long steps) {
+        Slot* slot = fThreadSlot;
+        if (!slot) {
+            return;
+        }
+        slot->events.store(slot->events.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        slot->opticalPhotons.store(slot->opticalPhotons.load(std::memory_order_relaxed) + opticalPhotons,
+                                   std::memory_order_relaxed);
+        slot->steps.store(slot->steps.load(std::memory_order_relaxed) + steps, std::memory_order_relaxed);
+        slot->edep.store(slot->edep.load(std::memory_order_relaxed) + edep, std::memory_order_relaxed);
+    }
+
+private:
+    PMMetrics();
+
+    struct alignas(64) Slot {
+        std::atomic<G4long> events{0};
+        std::atomic<G4long> opticalPhotons{0};
+        std::atomic<G4long> steps{0};
+        std::atomic<G4double> edep{0.};
+        std::atomic<G4bool> active{false};
+    };
+
+    struct Snapshot {
+        G4double seconds = 0.;
+        G4long events = 0;
+        G4long opticalPhotons = 0;
+        G4long steps = 0;
+        G4double edep = 0.;
+    };
+
+    void WriterLoop();
+    void Write(G4bool finished);
+    Snapshot Sum() const;
+    static G4long ResidentBytes();
+
+    G4bool fEnabled;
+    G4double fInterval;
+    G4String fFileName;
+
+    Slot fSlots[kMaxSlots];
+    static G4ThreadLocal Slot* fThreadSlot;
+
+    // Master and writer thread only.
+    G4int fRunID;
+    G4int fEventsToProcess;
+    std::chrono::steady_clock::time_point fStart;
+    Snapshot fPrevious;
+    std::thread fThread;
+    std::mutex fWakeMutex;
+    std::condition_variable fWake;
+    G4bool fStop;
+
+    PMMetricsMessenger* fMessenger;
+};
+
+#endif
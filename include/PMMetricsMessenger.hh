@@ -0,0 +1,29 @@
+#ifndef PMMETRICSMESSENGER_HH
+#define PMMETRICSMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class PMMetrics;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAString;
+
+class PMMetricsMessenger : public G4UImessenger {
+public:
+    explicit PMMetricsMessenger(PMMetrics* metrics);
+    ~PMMetricsMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    PMMetrics* fMetrics;
+
+    G4UIdirectory* fDirectory;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWithADoubleAndUnit* fIntervalCmd;
+    G4UIcmdWithAString* fFileCmd;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef PMOPTICALMESSENGER_HH
+#define PMOPTICALMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class PMOpticalResponse;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+class G4UIcmdWithAnInteger;
+
+class PMOpticalMessenger : public G4UImessenger {
+public:
+    explicit PMOpticalMessenger(PMOpticalResponse* response);
+    ~PMOpticalMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    PMOpticalResponse* fResponse;
+
+    G4UIdirectory* fDirectory;
+    G4UIcmdWithAString* fModeCmd;
+    G4UIcmdWithAString* fMapFileCmd;
+    G4UIcommand* fMapBinsCmd;
+    G4UIcmdWithADouble* fKeepFractionCmd;
+    G4UIcmdWithAnInteger* fRouletteBouncesCmd;
+    G4UIcmdWithADouble* fRouletteSurvivalCmd;
+};
+
+#endif
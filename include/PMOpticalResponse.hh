@@ -0,0 +1,83 @@
+#ifndef PMOPTICALRESPONSE_HH
+#define PMOPTICALRESPONSE_HH
+
+#include "PMLightCollectionMap.hh"
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+#include "globals.hh"
+
+class PMOpticalMessenger;
+
+// How optical photons are handled, shared by all threads.
+//   full       track every photon (default)
+//   calibrate  track every photon and fill the light-collection map,
+//              written to the map file at the end of the run
+//   fast       kill photons at birth; each one is counted as detected with
+//              the probability stored in the map for its emission cell
+//   off        kill photons at birth; they are counted as created only
+//
+// Variance reduction for the tracked modes (full, calibrate): only a
+// fraction f of the new photons is kept, with weight 1/f, and a photon is
+// rouletted every N boundary interactions, surviving with probability p and
+// weight multiplied by 1/p. Detections are summed as weights, so the
+// expected detected weight equals the unbiased detected count.
+class PMOpticalResponse {
+public:
+    enum Mode { kFull = 0, kCalibrate, kFast, kOff };
+
+    static PMOpticalResponse* Instance();
+
+    Mode GetMode() const { return fMode; }
+    void SetMode(Mode mode) { fMode = mode; }
+    static Mode ParseMode(const G4String& name);
+    static const char* ModeName(Mode mode);
+
+    G4double GetKeepFraction() const { return fKeepFraction; }
+    void SetKeepFraction(G4double fraction) { fKeepFraction = fraction; }
+    G4int GetRouletteBounces() const { return fRouletteBounces; }
+    void SetRouletteBounces(G4int bounces) { fRouletteBounces = bounces; }
+    G4double GetRouletteSurvival() const { return fRouletteSurvival; }
+    void SetRouletteSurvival(G4double probability) { fRouletteSurvival = probability; }
+
+    const G4String& GetMapFile() const { return fMapFile; }
+    void SetMapFile(const G4String& fileName) { fMapFile = fileName; }
+    void SetBinning(G4int nx, G4int ny, G4int nz, G4int nWavelength);
+
+    // Published by PMDetectorConstruction; maps are binned over this box.
+    void SetCrystalHalfSize(const G4ThreeVector& halfSize) { fCrystalHalfSize = halfSize; }
+
+    // Master only: load the map (fast) or prepare an empty one (calibrate).
+    void BeginOfRun();
+    // Master only: write the merged calibration map.
+    void EndOfRun();
+
+    // Per-thread calibration map: prepared before the thread's first event,
+    // merged into the master's map after its last one.
+    void BeginOfThreadRun();
+    PMLightCollectionMap* GetThreadMap() const { return fThreadMap; }
+    void MergeThreadMap();
+
+    // Read-only during a fast run.
+    const PMLightCollectionMap& GetMap() const { return fMap; }
+
+private:
+    PMOpticalResponse();
+
+    void ConfigureMap(PMLightCollectionMap& map) const;
+
+    Mode fMode;
+    G4double fKeepFraction;
+    G4int fRouletteBounces;
+    G4double fRouletteSurvival;
+    G4String fMapFile;
+    G4int fNx, fNy, fNz, fNWavelength;
+    G4ThreeVector fCrystalHalfSize;
+
+    PMLightCollectionMap fMap;
+    G4Mutex fMergeMutex;
+    static G4ThreadLocal PMLightCollectionMap* fThreadMap;
+
+    PMOpticalMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef PMOUTPUTMANAGER_HH
+#define PMOUTPUTMANAGER_HH
+
+#include "globals.hh"
+
+class PMOutputMessenger;
+
+// Output backends and file naming, shared by all threads.
+//   root      G4AnalysisManager ntuples, merged on the master at run end
+//   columnar  one chunked .pmc file per worker, written by a background
+//             thread (see PMColumnarWriter); no merge step
+class PMOutputManager {
+public:
+    static PMOutputManager* Instance();
+
+    G4bool IsRootEnabled() const { return fRoot; }
+    G4bool IsColumnarEnabled() const { return fColumnar; }
+    void SetFormat(const G4String& format);
+    G4String GetFormat() const;
+
+    G4int GetChunkRows() const { return fChunkRows; }
+    void SetChunkRows(G4int rows) { fChunkRows = rows; }
+    G4bool GetCompress() const { return fCompress; }
+    void SetCompress(G4bool compress) { fCompress = compress; }
+
+    // Per-photon records at the aluminum window (Photons ntuple /
+    // _photons.pmc). Off by default.
+    G4bool IsPhotonRecordingEnabled() const { return fPhotonRecords; }
+    void SetPhotonRecording(G4bool enable) { fPhotonRecords = enable; }
+
+    // Optional label replacing the energy in file names, so each point of a
+    // parameter scan writes its own outputs.
+    const G4String& GetTag() const { return fTag; }
+    void SetTag(const G4String& tag) { fTag = tag; }
+
+    // File name stem shared by every output of a run, e.g.
+    // "simulation_output_5MeV" or "simulation_output_<tag>", plus
+    // "_shard<i>" in shard mode.
+    G4String GetBaseName(G4double energy) const;
+    // Per-thread file name: <base>_t<thread><suffix>.
+    G4String GetThreadFileName(G4double energy, const G4String& suffix) const;
+
+private:
+    PMOutputManager();
+
+    G4bool fRoot;
+    G4bool fColumnar;
+    G4int fChunkRows;
+    G4bool fCompress;
+    G4bool fPhotonRecords;
+    G4String fTag;
+
+    PMOutputMessenger* fMessenger;
+};
+
+#endif
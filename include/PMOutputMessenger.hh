@@ -0,0 +1,31 @@
+#ifndef PMOUTPUTMESSENGER_HH
+#define PMOUTPUTMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class PMOutputManager;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+
+class PMOutputMessenger : public G4UImessenger {
+public:
+    explicit PMOutputMessenger(PMOutputManager* manager);
+    ~PMOutputMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    PMOutputManager* fManager;
+
+    G4UIdirectory* fDirectory;
+    G4UIcmdWithAString* fFormatCmd;
+    G4UIcmdWithAnInteger* fChunkRowsCmd;
+    G4UIcmdWithABool* fCompressCmd;
+    G4UIcmdWithABool* fPhotonsCmd;
+    G4UIcmdWithAString* fTagCmd;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef PMPHOTONRECORDBUFFER_HH
+#define PMPHOTONRECORDBUFFER_HH
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+#include <vector>
+
+// Per-event records of optical photons reaching the aluminum window, kept
+// as one vector per field. Clear() keeps the capacity, so after the first
+// few events recording a photon is a handful of stores. The vectors are
+// bound directly to the ROOT "Photons" ntuple columns.
+class PMPhotonRecordBuffer {
+public:
+    PMPhotonRecordBuffer();
+
+    void Clear();
+    void Reserve(std::size_t n);
+
+    void Add(const G4ThreeVector& arrival, G4double time, G4double wavelength,
+             G4int bounces, const G4ThreeVector& creation, G4double weight) {
+        fX.push_back(arrival.x());
+        fY.push_back(arrival.y());
+        fZ.push_back(arrival.z());
+        fTime.push_back(time);
+        fWavelength.push_back(wavelength);
+        fBounces.push_back(bounces);
+        fCreationX.push_back(creation.x());
+        fCreationY.push_back(creation.y());
+        fCreationZ.push_back(creation.z());
+        fWeight.push_back(weight);
+    }
+
+    std::size_t Size() const { return fX.size(); }
+
+    // Units: mm, ns, nm.
+    std::vector<G4double> fX, fY, fZ;
+    std::vector<G4double> fTime;
+    std::vector<G4double> fWavelength;
+    std::vector<G4int> fBounces;
+    std::vector<G4double> fCreationX, fCreationY, fCreationZ;
+    // Track weight at detection (Russian roulette, biasing).
+    std::vector<G4double> fWeight;
+};
+
+#endif
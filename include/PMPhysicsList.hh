@@ -3,9 +3,19 @@
 
 #include "G4VModularPhysicsList.hh"
 
+// "full": EM + optical + decay, radioactive decay, QGSP_BERT_HP hadrons,
+//         ions and stopping physics (the original configuration).
+// "lean": EM + optical only, with the minimal EM particle set. Enough for
+//         the few-MeV gamma sources used here, without the HP neutron data.
+// Both register G4FastSimulationPhysics for electrons, used by the
+// parametrized crystal response when /PM/fastsim/enable is set.
+//
+// With a table cache directory set, the physics tables are stored after the
+// first build under <dir>/<config>_g4v<version>_<cuts>/ and retrieved by
+// later jobs with the same configuration and cuts.
 class PMPhysicsList : public G4VModularPhysicsList {
 public:
-    PMPhysicsList();
+    explicit PMPhysicsList(const G4String& config = "full");
     virtual ~PMPhysicsList();
 
     void ConstructParticle() override;
@@ -14,6 +24,22 @@ public:
 
     void DefineParticles();
     void DefineCuts();
+
+    const G4String& GetConfig() const { return fConfig; }
+    G4bool IsLean() const { return fConfig == "lean"; }
+
+    void SetTableCacheDirectory(const G4String& dir) { fTableCacheDir = dir; }
+    G4String GetTableCacheKey() const;
+    // Master only, once the tables are built (first BeginOfRunAction).
+    void StoreTableCache();
+
+private:
+    void PrepareTableCache();
+
+    G4String fConfig;
+    G4String fTableCacheDir;
+    G4String fTableCachePath;
+    G4bool fStoreTableCache = false;
 };
 
 #endif
@@ -0,0 +1,37 @@
+#ifndef PMPRIMARYFILE_HH
+#define PMPRIMARYFILE_HH
+
+#include "PMPrimaryFormat.hh"
+#include "globals.hh"
+
+// Read-only memory mapping of a primary file (see PMPrimaryFormat.hh).
+// Opening checks the header and the size once; an event is then two index
+// loads and a pointer range, with no parsing or copying. Every worker maps
+// the same file, so the pages are shared.
+class PMPrimaryFile {
+public:
+    PMPrimaryFile() = default;
+    ~PMPrimaryFile();
+    PMPrimaryFile(const PMPrimaryFile&) = delete;
+    PMPrimaryFile& operator=(const PMPrimaryFile&) = delete;
+
+    G4bool Open(const G4String& fileName);
+    void Close();
+
+    G4bool IsOpen() const { return fData != nullptr; }
+    const G4String& GetFileName() const { return fFileName; }
+    std::uint64_t GetNumberOfEvents() const { return fNEvents; }
+
+    const PMPrimaries::Record* Begin(std::uint64_t event) const { return fRecords + fIndex[event]; }
+    const PMPrimaries::Record* End(std::uint64_t event) const { return fRecords + fIndex[event + 1]; }
+
+private:
+    G4String fFileName;
+    void* fData = nullptr;
+    std::size_t fSize = 0;
+    std::uint64_t fNEvents = 0;
+    const std::uint64_t* fIndex = nullptr;
+    const PMPrimaries::Record* fRecords = nullptr;
+};
+
+#endif
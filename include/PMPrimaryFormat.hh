@@ -0,0 +1,47 @@
+#ifndef PMPRIMARYFORMAT_HH
+#define PMPRIMARYFORMAT_HH
+
+// On-disk layout of a pre-generated primary file, shared by PMPrimaryFile
+// and the standalone pm_primaries converter (plain types, no Geant4).
+//
+//   FileHeader
+//   std::uint64_t firstRecord[nEvents + 1]   event i = records [first[i], first[i+1])
+//   Record[nRecords]
+//
+// Little-endian, 8-byte aligned throughout, so the whole file is used in
+// place through mmap. Each record becomes its own primary vertex.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PMPrimaries {
+
+constexpr char kFileMagic[8] = {'P', 'M', 'P', 'R', 'I', 'M', '0', '1'};
+
+struct FileHeader {
+    char magic[8];
+    std::uint64_t nEvents;
+    std::uint64_t nRecords;
+};
+
+struct Record {
+    std::int32_t pdg;
+    float time;          // ns
+    float position[3];   // mm
+    float direction[3];  // unit vector
+    float energy;        // kinetic energy, MeV
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 24, "unexpected FileHeader padding");
+static_assert(sizeof(Record) == 40, "unexpected Record padding");
+
+inline std::size_t IndexOffset() { return sizeof(FileHeader); }
+
+inline std::size_t RecordOffset(std::uint64_t nEvents) {
+    return sizeof(FileHeader) + (nEvents + 1) * sizeof(std::uint64_t);
+}
+
+}  // namespace PMPrimaries
+
+#endif
@@ -5,11 +5,32 @@
 #include "G4ParticleGun.hh"
 #include "G4ThreeVector.hh"
 #include "G4SystemOfUnits.hh"
+#include "PMPrimaryFile.hh"
+
+#include <vector>
 
 class G4Event;
+class G4ParticleDefinition;
+class G4PrimaryVertex;
+class PMPrimaryGeneratorMessenger;
 
+// Source modes (/PM/gun/source):
+//   gun       one gamma per decay, mean energy with a Gaussian spread (default)
+//   isotope   the gamma lines of Cs137, Co60 or Na22 per decay, each emitted
+//             with its intensity; Na22 annihilation photons come in
+//             back-to-back pairs
+//   spectrum  one gamma per decay, energy drawn from a line table
+//   file      replay of a pre-generated primary file (PMPrimaryFile)
+//
+// The first three emit from the source disc into the cone toward the
+// crystal (angular correlations between cascade gammas are not modelled),
+// /PM/gun/decaysPerEvent decays per event, one vertex each. File mode
+// takes every vertex from the file; event i of the run replays file event
+// i modulo the number of events in the file.
 class PMPrimaryGenerator : public G4VUserPrimaryGeneratorAction {
 public:
+    enum Source { kGun = 0, kIsotope, kSpectrum, kFile };
+
     explicit PMPrimaryGenerator(G4double energy); 
     virtual ~PMPrimaryGenerator();
 
@@ -21,13 +42,40 @@ public:
     void SetBeamSpreadAngle(G4double angle);
     void SetEnergySigma(G4double sigma);
 
+    G4double GetGammaEnergy() const;
     G4double GetSourceDistance() const;
     G4double GetSourceRadius() const;
     G4double GetBeamSpreadAngle() const;
     G4double GetEnergySigma() const;
 
+    static const char* SourceName(Source source);
+    void SetSource(Source source) { fSource = source; }
+    Source GetSource() const { return fSource; }
+    // Return false (with a warning) and leave the source unchanged on error.
+    G4bool SetSource(const G4String& name);
+    G4bool SetIsotope(const G4String& name);
+    G4bool LoadSpectrum(const G4String& fileName);
+    G4bool OpenPrimaryFile(const G4String& fileName);
+    const G4String& GetIsotope() const { return fIsotope; }
+    const G4String& GetSpectrumFile() const { return fSpectrumFile; }
+    const G4String& GetPrimaryFile() const { return fPrimaryFile.GetFileName(); }
+
+    void SetDecaysPerEvent(G4int decays) { fDecaysPerEvent = decays; }
+    G4int GetDecaysPerEvent() const { return fDecaysPerEvent; }
+
 private:
+    struct Line {
+        G4double energy;
+        G4double intensity;  // per decay; cumulative for spectra
+        G4bool pair;         // two back-to-back photons
+    };
+
     void UpdatePositionAndDirection();
+    G4ThreeVector SamplePosition() const;
+    G4ThreeVector SampleDirection() const;
+    void AddGamma(G4PrimaryVertex* vertex, G4double energy, const G4ThreeVector& direction) const;
+    void GenerateDecays(G4Event* event);
+    void GenerateFromFile(G4Event* event);
 
     G4ParticleGun* fParticleGun;
     G4double fBaseEnergy;
@@ -35,6 +83,18 @@ private:
     G4double fSourcePosZ;
     G4double fSourceRadius;
     G4double fBeamSpreadAngle;
+
+    Source fSource;
+    G4int fDecaysPerEvent;
+    G4String fIsotope;
+    std::vector<Line> fIsotopeLines;
+    G4String fSpectrumFile;
+    std::vector<Line> fSpectrum;
+    PMPrimaryFile fPrimaryFile;
+    G4int fLastPdg;
+    G4ParticleDefinition* fLastParticle;
+
+    PMPrimaryGeneratorMessenger* fMessenger;
 };
 
 #endif  // PMPRIMARYGENERATOR_HH
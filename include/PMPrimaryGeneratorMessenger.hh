@@ -0,0 +1,38 @@
+#ifndef PMPRIMARYGENERATORMESSENGER_HH
+#define PMPRIMARYGENERATORMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class PMPrimaryGenerator;
+class G4UIdirectory;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+
+// One instance per generator, i.e. per worker thread; the commands are
+// broadcast to all workers.
+class PMPrimaryGeneratorMessenger : public G4UImessenger {
+public:
+    explicit PMPrimaryGeneratorMessenger(PMPrimaryGenerator* generator);
+    ~PMPrimaryGeneratorMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    PMPrimaryGenerator* fGenerator;
+
+    G4UIdirectory* fDirectory;
+    G4UIcmdWithADoubleAndUnit* fEnergyCmd;
+    G4UIcmdWithADoubleAndUnit* fEnergySigmaCmd;
+    G4UIcmdWithADoubleAndUnit* fDistanceCmd;
+    G4UIcmdWithADoubleAndUnit* fRadiusCmd;
+    G4UIcmdWithADoubleAndUnit* fSpreadCmd;
+    G4UIcmdWithAString* fSourceCmd;
+    G4UIcmdWithAString* fIsotopeCmd;
+    G4UIcmdWithAString* fSpectrumCmd;
+    G4UIcmdWithAString* fFileCmd;
+    G4UIcmdWithAnInteger* fDecaysCmd;
+};
+
+#endif
@@ -3,20 +3,84 @@
 
 #include "G4UserRunAction.hh"
 #include "G4Run.hh"
+#include "G4Accumulable.hh"
 #include "G4AnalysisManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Timer.hh"
 #include "globals.hh"
+#include "PMPhotonRecordBuffer.hh"
+#include "PMHistogramSet.hh"
+
+class PMColumnarWriter;
 
 class PMRunAction : public G4UserRunAction {
 public:
+    // Per-event columns, in the same order in the ROOT "Events" ntuple and
+    // the columnar event stream.
+    enum EventColumn { kEventID = 0, kOptical, kGammaTeflon, kAluminum, kScintillation, kEdep,
+                       kAluminumWeight, kDigiCharge, kDigiTime };
+
+    // Merged totals of the last completed run (master only).
+    struct RunTotals {
+        G4int events = 0;
+        G4long steps = 0;
+        G4long opticalPhotons = 0;
+        G4long aluminumPhotons = 0;
+        G4double aluminumWeight = 0.;
+        G4long scintillationPhotons = 0;
+        G4long gammasAtTeflon = 0;
+        G4double energyDeposit = 0.;
+        G4double seconds = 0.;
+    };
+
     PMRunAction(G4double energy);  
     ~PMRunAction();
 
     virtual void BeginOfRunAction(const G4Run* run);
     virtual void EndOfRunAction(const G4Run* run);
 
+    // Called by the event action of the same thread once per event; the
+    // per-thread totals are merged into the master at the end of the run.
+    void AddEvent(G4int opticalPhotons, G4int aluminumPhotons,
+                  G4int scintillationPhotons, G4int gammasAtTeflon, G4double edep,
+                  G4long steps, G4double aluminumWeight);
+
+    const RunTotals& GetLastRunTotals() const { return fLastRun; }
+
+    // Worker-side columnar event stream; null unless /PM/output/format
+    // includes columnar.
+    PMColumnarWriter* GetEventWriter() const { return fEventWriter; }
+    PMColumnarWriter* GetPhotonWriter() const { return fPhotonWriter; }
+
+    // Per-thread photon record store, bound to the "Photons" ntuple.
+    PMPhotonRecordBuffer* GetPhotonRecords() { return &fPhotonRecords; }
+
+    // This thread's histograms; on the master, the merged result after
+    // EndOfRunAction.
+    PMHistogramSet* GetHistograms() { return &fHistograms; }
+
 private:
     G4double fEnergy;  
+    G4Timer fTimer;
+    PMColumnarWriter* fEventWriter;
+    PMColumnarWriter* fPhotonWriter;
+    PMPhotonRecordBuffer fPhotonRecords;
+    PMHistogramSet fHistograms;
+
+    void OpenColumnarWriters();
+    void WriteHistograms();
+    void WriteCounters(G4int runID);
+
+    // Per-event counts fit an int; run totals of long optical runs do not.
+    G4Accumulable<G4long> fOpticalPhotons;
+    G4Accumulable<G4long> fAluminumPhotons;
+    G4Accumulable<G4double> fAluminumWeight;
+    G4Accumulable<G4long> fScintillationPhotons;
+    G4Accumulable<G4long> fGammasAtTeflon;
+    G4Accumulable<G4double> fEnergyDeposit;
+    G4Accumulable<G4long> fSteps;
+
+    RunTotals fLastRun;
 };
 
 #endif
@@ -0,0 +1,124 @@
+#ifndef PMSCORINGMESH_HH
+#define PMSCORINGMESH_HH
+
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+#include "globals.hh"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+class PMScoringMeshMessenger;
+
+// Voxel grid over the crystal box (module frame) in blocks of 8x8x8
+// voxels. Blocks are allocated on first touch, so a 1 mm mesh of the
+// 10 x 10 x 3 cm crystal (300k voxels) only holds memory where something
+// was scored; the block directory itself is one pointer per 512 voxels.
+class PMScoringGrid {
+public:
+    enum Quantity { kEdep = 0, kPhotonOrigins, kQuantities };
+
+    static constexpr G4int kBlockBits = 3;
+    static constexpr G4int kBlockSize = 1 << kBlockBits;
+    static constexpr G4int kBlockVoxels = kBlockSize * kBlockSize * kBlockSize;
+
+    struct Block {
+        G4double values[kQuantities][kBlockVoxels];
+    };
+
+    PMScoringGrid();
+
+    // Keeps the allocated blocks (zeroed) when the layout is unchanged.
+    void Configure(const G4ThreeVector& halfSize, G4double pitch);
+    void Clear();
+
+    // Points outside the box are ignored.
+    void Add(Quantity quantity, const G4ThreeVector& local, G4double value) {
+        const G4int ix = static_cast<G4int>(std::floor((local.x() + fHalfSize.x()) * fInversePitch));
+        const G4int iy = static_cast<G4int>(std::floor((local.y() + fHalfSize.y()) * fInversePitch));
+        const G4int iz = static_cast<G4int>(std::floor((local.z() + fHalfSize.z()) * fInversePitch));
+        if (ix < 0 || iy < 0 || iz < 0 || ix >= fNx || iy >= fNy || iz >= fNz) {
+            return;
+        }
+        std::unique_ptr<Block>& block =
+            fBlocks[(ix >> kBlockBits) + fBx * ((iy >> kBlockBits) + fBy * (iz >> kBlockBits))];
+        if (!block) {
+            block.reset(new Block());
+        }
+        const G4int mask = kBlockSize - 1;
+        block->values[quantity][(ix & mask) | (iy & mask) << kBlockBits | (iz & mask) << (2 * kBlockBits)] +=
+            value;
+    }
+
+    G4int GetBlockCount() const { return static_cast<G4int>(fBlocks.size()); }
+    const Block* GetBlock(G4int index) const { return fBlocks[index].get(); }
+    Block* GetOrCreateBlock(G4int index);
+    G4int GetAllocatedBlocks() const;
+
+    G4int GetNx() const { return fNx; }
+    G4int GetNy() const { return fNy; }
+    G4int GetNz() const { return fNz; }
+    G4int GetBx() const { return fBx; }
+    G4int GetBy() const { return fBy; }
+    G4double GetPitch() const { return fPitch; }
+    const G4ThreeVector& GetHalfSize() const { return fHalfSize; }
+
+    // Binary volume, sparse by block (see PMScoringMesh.cc).
+    G4bool Save(const G4String& fileName) const;
+
+private:
+    G4ThreeVector fHalfSize;
+    G4double fPitch;
+    G4double fInversePitch;
+    G4int fNx, fNy, fNz;
+    G4int fBx, fBy, fBz;
+    std::vector<std::unique_ptr<Block>> fBlocks;
+};
+
+// Energy deposit and optical photon origin maps over the crystal
+// (/PM/mesh/), summed over all modules in the module frame. Disabled by
+// default; the stepping and stacking actions then only test a
+// thread-local pointer. Each thread scores into its own grid, which is
+// added block by block into the master's grid at the end of the thread's
+// run. Blocks are guarded by striped locks, so threads merging different
+// parts of the crystal do not wait for each other. The master writes
+// <stem>_mesh.pmm.
+class PMScoringMesh {
+public:
+    static PMScoringMesh* Instance();
+
+    G4bool IsEnabled() const { return fEnabled; }
+    void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+    G4double GetPitch() const { return fPitch; }
+    void SetPitch(G4double pitch) { fPitch = pitch; }
+
+    // Published by PMDetectorConstruction.
+    void SetCrystalHalfSize(const G4ThreeVector& halfSize) { fCrystalHalfSize = halfSize; }
+
+    static PMScoringGrid* GetThreadGrid() { return fThreadGrid; }
+
+    // Master only.
+    void BeginOfRun();
+    void EndOfRun(const G4String& stem);
+
+    void BeginOfThreadRun();
+    void MergeThreadGrid();
+
+private:
+    PMScoringMesh();
+
+    static constexpr G4int kStripes = 64;
+
+    G4bool fEnabled;
+    G4double fPitch;
+    G4ThreeVector fCrystalHalfSize;
+
+    PMScoringGrid fMerged;
+    G4Mutex fStripes[kStripes];
+    static G4ThreadLocal PMScoringGrid* fThreadGrid;
+
+    PMScoringMeshMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef PMSCORINGMESHMESSENGER_HH
+#define PMSCORINGMESHMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class PMScoringMesh;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+
+class PMScoringMeshMessenger : public G4UImessenger {
+public:
+    explicit PMScoringMeshMessenger(PMScoringMesh* mesh);
+    ~PMScoringMeshMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    PMScoringMesh* fMesh;
+
+    G4UIdirectory* fDirectory;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWithADoubleAndUnit* fPitchCmd;
+};
+
+#endif
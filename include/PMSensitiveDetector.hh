@@ -2,26 +2,61 @@
 #define PMSENSITIVEDETECTOR_HH 1
 
 #include "G4VSensitiveDetector.hh"
+#include "G4VFastSimSensitiveDetector.hh"
 #include "G4ThreeVector.hh"
-#include "G4EventManager.hh"
+#include "PMHit.hh"
+#include <vector>
 
 class G4Step;
 class G4HCofThisEvent;
+class G4Material;
+class PMEmissionSpectrum;
 
-class PMSensitiveDetector : public G4VSensitiveDetector {
+// The single readout path of a detector module. Attached to the crystal
+// and the aluminum window of every module; fills two hit collections per
+// event, "<name>/edep" and "<name>/photons" (see PMHit), which the event
+// action reads once in EndOfEventAction. Fast hits from
+// PMFastScintillatorModel add energy the same way and are converted into
+// detected photons statistically.
+class PMSensitiveDetector : public G4VSensitiveDetector, public G4VFastSimSensitiveDetector {
 public:
     PMSensitiveDetector(const G4String& name);
     virtual ~PMSensitiveDetector();
 
     virtual void Initialize(G4HCofThisEvent*);
     virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory*);
+    G4bool ProcessHits(const G4FastHit* hit, const G4FastTrack* track, G4TouchableHistory* touchable) override;
     void EndOfEvent(G4HCofThisEvent*) override;
 
+    // True for an optical photon step that ends at the aluminum window:
+    // stepping into the plate (it has no RINDEX, so the boundary process
+    // kills the photon there), a step inside it, or an optical surface
+    // reporting Detection.
+    static G4bool IsDetection(const G4Step* step);
+
 private:
-    G4int fTotalOpticalPhotons;     
-    G4int fPhotonsAtScintillator;  
-    G4int fPhotonsAtAluminum;      
-    G4double fTotalEnergyDeposited;
+    void AddEnergy(G4int module, G4double energy, G4double time);
+    // Scintillation photons for a deposit (yield and resolution scale of
+    // the crystal, as G4Scintillation), thinned with the light-collection
+    // efficiency at the crystal-frame position. Also caches the crystal's
+    // emission spectrum and decay time for the photon hits.
+    G4int SampleDetectedPhotons(const G4Material* material, G4double energy,
+                                const G4ThreeVector& position);
+
+    PMHitsCollection* fEdepHits;
+    PMHitsCollection* fPhotonHits;
+    G4int fEdepCollectionID;
+    G4int fPhotonCollectionID;
+    std::size_t fLastEdepHits;
+    std::size_t fLastPhotonHits;
+    std::vector<G4int> fModuleEdepHit;  // module -> index in fEdepHits, -1 if none yet
+    G4int fTotalOpticalPhotons;
+    G4int fPhotonsAtScintillator;
+    const G4Material* fYieldMaterial;
+    G4double fYield;
+    G4double fResolutionScale;
+    G4double fDecayTime;
+    const PMEmissionSpectrum* fSpectrum;
 };
 
 #endif
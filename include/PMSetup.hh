@@ -0,0 +1,35 @@
+#ifndef PMSETUP_HH
+#define PMSETUP_HH
+
+#include "globals.hh"
+
+class G4RunManager;
+struct PMCommandLine;
+
+// Start-up shared by sim, sim_batch and sim_bench, so every executable
+// registers the same /PM/ commands and seeds and shards the same way.
+// Call on the master before any macro is executed.
+class PMSetup {
+public:
+    // All of the below, for the PMCommandLine executables: gamma energy
+    // 5 MeV, seed and shard from the options.
+    static G4RunManager* CreateRunManager(const PMCommandLine& options);
+
+    // Default run manager type (tasking/MT when Geant4 has threads;
+    // G4RUN_MANAGER_TYPE overrides it), with nThreads workers.
+    static G4RunManager* CreateRunManager(G4int nThreads);
+
+    // Creates the shared configuration singletons, and with them their
+    // messengers, so their commands exist before the first macro line.
+    static void InitSingletons();
+
+    // index in [0, count); seed 0 leaves the engine and per-event
+    // reseeding alone.
+    static void ConfigureShard(G4int index, G4int count, G4long seed);
+
+    // Detector, physics list (empty tableCache = no cache) and actions.
+    static void SetUserInitializations(G4RunManager* runManager, const G4String& physics,
+                                       const G4String& tableCache, G4double energy);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef PMSHARD_HH
+#define PMSHARD_HH
+
+#include "globals.hh"
+
+// Splits one logical run over independent processes (sim --shard i/N).
+//
+// Every shard runs the macro's /run/beamOn n events; shard i covers the
+// global events [i*n, (i+1)*n) of a run with N*n events. With a master
+// seed set, the random engine is reseeded at the start of each event from
+// (master seed, run ID, global event ID) only, so an event's history does
+// not depend on the shard, thread or order it was processed in, and the
+// shards reproduce a single-process run with the same seed.
+class PMShard {
+public:
+    static PMShard* Instance();
+
+    // index in [0, count); count 1 disables sharding.
+    void Configure(G4int index, G4int count);
+    G4int GetIndex() const { return fIndex; }
+    G4int GetCount() const { return fCount; }
+    G4bool IsSharded() const { return fCount > 1; }
+
+    // Per-event reseeding is enabled by a master seed or by sharding.
+    void SetMasterSeed(G4long seed);
+    G4long GetMasterSeed() const { return fMasterSeed; }
+    G4bool IsSeeding() const { return fSeeding; }
+
+    // Master, at the start of each run. Fatal (PMRun002) when the global
+    // event IDs of the whole sharded run do not fit the int event columns.
+    void BeginOfRun(G4int eventsInRun);
+
+    G4long GetGlobalEventID(G4int eventID) const {
+        return static_cast<G4long>(fIndex) * fEventsPerShard + eventID;
+    }
+    void SeedEvent(G4int runID, G4int eventID) const;
+
+    // "" or "_shard<i>", appended to every output file stem.
+    G4String GetFileSuffix() const;
+
+    // Parses "i/N"; false on malformed input or i outside [0, N).
+    static G4bool Parse(const char* text, G4int& index, G4int& count);
+
+private:
+    PMShard();
+
+    G4int fIndex;
+    G4int fCount;
+    G4int fEventsPerShard;
+    G4long fMasterSeed;
+    G4bool fSeeding;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef PMSPSCQUEUE_HH
+#define PMSPSCQUEUE_HH
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free ring for exactly one producer and one consumer thread.
+// Capacity is N - 1; N must be a power of two.
+template <typename T, std::size_t N>
+class PMSpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "PMSpscQueue size must be a power of two");
+
+public:
+    PMSpscQueue() : fHead(0), fTail(0) {}
+
+    bool Push(const T& value) {
+        std::size_t head = fHead.load(std::memory_order_relaxed);
+        std::size_t next = (head + 1) & (N - 1);
+        if (next == fTail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        fBuffer[head] = value;
+        fHead.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& value) {
+        std::size_t tail = fTail.load(std::memory_order_relaxed);
+        if (tail == fHead.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = fBuffer[tail];
+        fTail.store((tail + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<std::size_t> fHead;
+    alignas(64) std::atomic<std::size_t> fTail;
+    alignas(64) T fBuffer[N];
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef PMSTACKINGACTION_HH
+#define PMSTACKINGACTION_HH
+
+#include "G4UserStackingAction.hh"
+#include "G4ThreeVector.hh"
+#include "G4TouchableHandle.hh"
+#include "G4TrackVector.hh"
+
+#include <vector>
+
+class PMEventAction;
+class PMOpticalResponse;
+class PMEmissionSpectrum;
+class PMStackingMessenger;
+class G4ParticleDefinition;
+class G4Scintillation;
+class G4Step;
+class G4Material;
+
+// Optical-photon stacking, shared by all threads (/PM/stack/).
+class PMStackingConfig {
+public:
+    static PMStackingConfig* Instance();
+
+    G4bool IsLazyScintillation() const { return fLazyScintillation; }
+    void SetLazyScintillation(G4bool lazy) { fLazyScintillation = lazy; }
+    G4int GetBatchSize() const { return fBatchSize; }
+    void SetBatchSize(G4int photons) { fBatchSize = photons; }
+
+private:
+    PMStackingConfig();
+
+    G4bool fLazyScintillation;
+    G4int fBatchSize;
+    PMStackingMessenger* fMessenger;
+};
+
+// Classifies new tracks: counts every optical photon and applies the
+// optical mode and downsampling.
+//
+// With lazy scintillation, G4Scintillation only counts the photons of a
+// step; the stepping action stores one emission record per scintillating
+// step instead (position, time, count, parent). Once the urgent stack is
+// empty, NewStage turns at most batchSize records' worth of photons into
+// tracks, sampling position and time along the step, the crystal decay
+// time and PMEmissionSpectrum energies, so no more than one batch of
+// optical photons is alive at a time whatever the deposited energy.
+class PMStackingAction : public G4UserStackingAction {
+public:
+    explicit PMStackingAction(PMEventAction* eventAction);
+    ~PMStackingAction() override;
+
+    G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track) override;
+    void NewStage() override;
+    void PrepareNewEvent() override;
+
+    // Called by the stepping action for steps depositing energy in the
+    // crystal while IsRecordingEmission().
+    G4bool IsRecordingEmission() const { return fLazy; }
+    void RecordEmission(const G4Step* step);
+
+    // Light-collection maps are binned in the crystal frame of the module.
+    static G4ThreeVector CrystalPosition(const G4Track* track);
+
+private:
+    struct EmissionRecord {
+        G4ThreeVector start;
+        G4ThreeVector delta;   // post - pre step position
+        G4double time;         // pre-step global time
+        G4double duration;
+        G4double weight;
+        G4double decayTime;
+        const PMEmissionSpectrum* spectrum;
+        G4TouchableHandle touchable;
+        G4int parentID;
+        G4int remaining;
+    };
+
+    // Keeps a photon with probability f (/PM/optical/keepFraction) and
+    // scales its weight by 1/f.
+    G4ClassificationOfNewTrack Downsample(const G4Track* track) const;
+    G4Track* MakePhoton(const EmissionRecord& record) const;
+
+    PMEventAction* fEventAction;
+    PMOpticalResponse* fResponse;
+    const G4ParticleDefinition* fOpticalPhoton;
+
+    // Looked up at the first event: workers build their processes after
+    // the user actions. Null without optical physics.
+    G4Scintillation* fScintillationProcess;
+    G4bool fProcessLookedUp;
+    G4bool fLazy;
+
+    // Material of the last recorded step and its emission constants.
+    const G4Material* fRecordMaterial;
+    const PMEmissionSpectrum* fRecordSpectrum;
+    G4double fRecordDecayTime;
+
+    // Reused from event to event.
+    std::vector<EmissionRecord> fPending;
+    G4TrackVector fBatch;
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef PMSTACKINGMESSENGER_HH
+#define PMSTACKINGMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class PMStackingConfig;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+
+class PMStackingMessenger : public G4UImessenger {
+public:
+    explicit PMStackingMessenger(PMStackingConfig* config);
+    ~PMStackingMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    PMStackingConfig* fConfig;
+
+    G4UIdirectory* fDirectory;
+    G4UIcmdWithABool* fLazyCmd;
+    G4UIcmdWithAnInteger* fBatchSizeCmd;
+};
+
+#endif
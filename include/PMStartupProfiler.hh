@@ -0,0 +1,58 @@
+#ifndef PMSTARTUPPROFILER_HH
+#define PMSTARTUPPROFILER_HH
+
+#include "globals.hh"
+#include <chrono>
+#include <vector>
+
+// Wall-clock breakdown of initialization, printed once when the first run
+// starts. Phases are timed with PMStartupScope; the physics-table phase
+// runs from the end of SetCuts (/run/initialize) to the master's first
+// BeginOfRunAction, which is where the run manager builds the tables.
+// Phases entered by several threads (e.g. SD setup on each worker) report
+// the number of calls and the slowest one.
+class PMStartupProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static PMStartupProfiler* Instance();
+
+    void Record(const G4String& phase, G4double seconds);
+    void MarkPhysicsInitialized();
+    // Master only; no-op after the first call.
+    void MarkRunStart();
+
+private:
+    PMStartupProfiler();
+
+    struct Phase {
+        G4String name;
+        G4int calls;
+        G4double total;
+        G4double max;
+    };
+
+    void Report() const;
+
+    Clock::time_point fStart;
+    Clock::time_point fPhysicsInitialized;
+    G4bool fHavePhysicsMark;
+    G4bool fReported;
+    std::vector<Phase> fPhases;
+};
+
+class PMStartupScope {
+public:
+    explicit PMStartupScope(const char* phase)
+        : fPhase(phase), fStart(PMStartupProfiler::Clock::now()) {}
+    ~PMStartupScope() {
+        std::chrono::duration<G4double> elapsed = PMStartupProfiler::Clock::now() - fStart;
+        PMStartupProfiler::Instance()->Record(fPhase, elapsed.count());
+    }
+
+private:
+    const char* fPhase;
+    PMStartupProfiler::Clock::time_point fStart;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef PMSTEPPROFILER_HH
+#define PMSTEPPROFILER_HH
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Threading.hh"
+#include "globals.hh"
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4VProcess;
+class PMStepProfilerMessenger;
+
+// Per-thread step accounting keyed by (particle, process, volume), with the
+// process that limited the step and the logical volume it was taken in.
+// Open addressing over raw pointers, so recording a step is a hash and a few
+// increments. Every Nth step is timed: the clock is read there and again at
+// the next step of the same track, and the interval is charged to that
+// next step's key (the stepping action runs at the end of each step).
+class PMStepProfileTable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        const G4ParticleDefinition* particle;
+        const G4VProcess* process;
+        const G4LogicalVolume* volume;
+        G4long steps;
+        G4long tracks;
+        G4long sampledSteps;
+        G4double sampledNs;
+    };
+
+    PMStepProfileTable();
+
+    // Clears all counters; 0 disables timing.
+    void Reset(G4int sampleInterval);
+
+    void Record(const G4Step* step) {
+        const G4Track* track = step->GetTrack();
+        const G4int stepNumber = track->GetCurrentStepNumber();
+        const G4VPhysicalVolume* volume = step->GetPreStepPoint()->GetPhysicalVolume();
+        Entry& entry = Find(track->GetDefinition(),
+                            step->GetPostStepPoint()->GetProcessDefinedStep(),
+                            volume ? volume->GetLogicalVolume() : nullptr);
+        ++entry.steps;
+        if (stepNumber == 1) {
+            ++entry.tracks;
+        }
+        if (fArmedTrack) {
+            if (track == fArmedTrack && stepNumber == fArmedStep + 1) {
+                entry.sampledNs += std::chrono::duration<G4double, std::nano>(Clock::now() - fArmedTime).count();
+                ++entry.sampledSteps;
+            }
+            fArmedTrack = nullptr;
+        }
+        if (fSampleInterval > 0 && --fCountdown <= 0) {
+            fCountdown = fSampleInterval;
+            fArmedTrack = track;
+            fArmedStep = stepNumber;
+            fArmedTime = Clock::now();
+        }
+    }
+
+    // Occupied entries; the last one collects keys that did not fit.
+    std::vector<const Entry*> GetEntries() const;
+
+private:
+    static constexpr std::size_t kCapacity = 4096;  // power of two
+
+    Entry& Find(const G4ParticleDefinition* particle, const G4VProcess* process,
+                const G4LogicalVolume* volume) {
+        Entry* last = fLast;
+        if (last->particle == particle && last->process == process && last->volume == volume) {
+            return *last;
+        }
+        std::size_t hash = (reinterpret_cast<std::size_t>(particle) >> 4)
+                         ^ (reinterpret_cast<std::size_t>(process) >> 4) * 31
+                         ^ (reinterpret_cast<std::size_t>(volume) >> 4) * 1031;
+        hash *= 0x9E3779B97F4A7C15ull;
+        std::size_t slot = hash >> 52;  // top 12 bits: kCapacity slots
+        for (std::size_t probe = 0; probe < kCapacity; ++probe, slot = (slot + 1) & (kCapacity - 1)) {
+            Entry& entry = fEntries[slot];
+            if (!entry.particle) {
+                if (fUsed >= kCapacity / 2) break;
+                entry.particle = particle;
+                entry.process = process;
+                entry.volume = volume;
+                ++fUsed;
+                return *(fLast = &entry);
+            }
+            if (entry.particle == particle && entry.process == process && entry.volume == volume) {
+                return *(fLast = &entry);
+            }
+        }
+        return fEntries[kCapacity];
+    }
+
+    std::vector<Entry> fEntries;
+    std::size_t fUsed;
+    Entry* fLast;
+
+    G4int fSampleInterval;
+    G4int fCountdown;
+    const G4Track* fArmedTrack;
+    G4int fArmedStep;
+    Clock::time_point fArmedTime;
+};
+
+// Step profiling switch and the merged result, shared by all threads.
+// Disabled by default; the stepping action then only tests a thread-local
+// pointer. Tables are merged by name at the end of each thread's run (the
+// process objects are per thread) and written by the master:
+//   <file>.txt     table sorted by estimated time
+//   <file>.folded  collapsed stacks particle;volume;process for flamegraph.pl
+class PMStepProfiler {
+public:
+    static PMStepProfiler* Instance();
+
+    G4bool IsEnabled() const { return fEnabled; }
+    void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+    G4int GetSampleInterval() const { return fSampleInterval; }
+    void SetSampleInterval(G4int interval) { fSampleInterval = interval; }
+    const G4String& GetFileName() const { return fFileName; }
+    void SetFileName(const G4String& fileName) { fFileName = fileName; }
+
+    static PMStepProfileTable* GetThreadTable() { return fThreadTable; }
+
+    // Master only.
+    void BeginOfRun();
+    void EndOfRun();
+
+    void BeginOfThreadRun();
+    void MergeThreadTable();
+
+private:
+    PMStepProfiler();
+
+    struct Totals {
+        G4long steps = 0;
+        G4long tracks = 0;
+        G4long sampledSteps = 0;
+        G4double sampledNs = 0.;
+    };
+
+    G4bool fEnabled;
+    G4int fSampleInterval;
+    G4String fFileName;
+
+    // Keyed by "particle;volume;process".
+    std::map<G4String, Totals> fMerged;
+    G4Mutex fMergeMutex;
+    static G4ThreadLocal PMStepProfileTable* fThreadTable;
+
+    PMStepProfilerMessenger* fMessenger;
+};
+
+#endif
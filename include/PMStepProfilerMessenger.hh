@@ -0,0 +1,29 @@
+#ifndef PMSTEPPROFILERMESSENGER_HH
+#define PMSTEPPROFILERMESSENGER_HH
+
+#include "G4UImessenger.hh"
+
+class PMStepProfiler;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithAString;
+
+class PMStepProfilerMessenger : public G4UImessenger {
+public:
+    explicit PMStepProfilerMessenger(PMStepProfiler* profiler);
+    ~PMStepProfilerMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+    G4String GetCurrentValue(G4UIcommand* command) override;
+
+private:
+    PMStepProfiler* fProfiler;
+
+    G4UIdirectory* fDirectory;
+    G4UIcmdWithABool* fStepsCmd;
+    G4UIcmdWithAnInteger* fSampleCmd;
+    G4UIcmdWithAString* fFileCmd;
+};
+
+#endif
@@ -2,18 +2,29 @@
 #define PMSTEPPINGACTION_HH
 
 #include "G4UserSteppingAction.hh"
+#include "globals.hh"
 
 class PMEventAction;
+class PMStackingAction;
+class PMVolumeRegistry;
+class PMOpticalResponse;
+class G4ParticleDefinition;
 
 class PMSteppingAction : public G4UserSteppingAction {
 public:
-    PMSteppingAction(PMEventAction* eventAction);
+    PMSteppingAction(PMEventAction* eventAction, PMStackingAction* stackingAction);
     virtual ~PMSteppingAction();
 
     virtual void UserSteppingAction(const G4Step* step) override;
 
 private:
     PMEventAction* fEventAction;
+    PMStackingAction* fStackingAction;
+    const PMVolumeRegistry* fRegistry;
+    PMOpticalResponse* fResponse;
+    const G4ParticleDefinition* fOpticalPhoton;
+    const G4ParticleDefinition* fGamma;
+    G4int fBounces;  // boundary interactions of the current optical photon
 };
 
 #endif
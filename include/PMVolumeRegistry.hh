@@ -0,0 +1,77 @@
+#ifndef PMVOLUMEREGISTRY_HH
+#define PMVOLUMEREGISTRY_HH
+
+#include "globals.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
+
+class G4OpBoundaryProcess;
+
+enum class PMVolumeID : G4int {
+    kUnknown = 0,
+    kWorld,
+    kModule,
+    kScintillator,
+    kTeflon,
+    kAluminum
+};
+
+// Maps the detector's logical volumes to a small enum so that stepping code
+// can classify a step with a few pointer compares instead of building and
+// comparing volume names. Filled by PMDetectorConstruction::Construct() on
+// the master before any worker starts, read-only afterwards.
+class PMVolumeRegistry {
+public:
+    static PMVolumeRegistry* Instance();
+
+    void Clear();
+    void Register(const G4LogicalVolume* logical, PMVolumeID id);
+
+    PMVolumeID Classify(const G4LogicalVolume* logical) const {
+        for (G4int i = 0; i < fCount; ++i) {
+            if (fVolumes[i] == logical) return fIDs[i];
+        }
+        return PMVolumeID::kUnknown;
+    }
+
+    PMVolumeID Classify(const G4VPhysicalVolume* physical) const {
+        return physical ? Classify(physical->GetLogicalVolume()) : PMVolumeID::kUnknown;
+    }
+
+    // Number of detector modules placed in the world (copy numbers
+    // 0 .. n-1), published with the volumes.
+    void SetModuleCount(G4int count) { fModuleCount = count; }
+    G4int GetModuleCount() const { return fModuleCount; }
+
+    // Modules are placed directly in the world, so level 1 of a touchable
+    // inside one is its module. -1 outside any module.
+    static G4int ModuleCopyNumber(const G4VTouchable* touchable) {
+        const G4int depth = touchable ? touchable->GetHistoryDepth() : 0;
+        return depth >= 1 ? touchable->GetCopyNumber(depth - 1) : -1;
+    }
+
+    // A global point in the frame of the touchable's module, which is
+    // centred on its crystal.
+    static G4ThreeVector ToModuleFrame(const G4VTouchable* touchable, const G4ThreeVector& global) {
+        if (!touchable || touchable->GetHistoryDepth() < 1) return global;
+        return touchable->GetHistory()->GetTransform(1).TransformPoint(global);
+    }
+
+    // The optical boundary process of the calling thread, looked up once.
+    static G4OpBoundaryProcess* GetBoundaryProcess();
+
+private:
+    PMVolumeRegistry();
+
+    static constexpr G4int kMaxVolumes = 16;
+    const G4LogicalVolume* fVolumes[kMaxVolumes];
+    PMVolumeID fIDs[kMaxVolumes];
+    G4int fCount;
+    G4int fModuleCount;
+
+    static G4ThreadLocal G4OpBoundaryProcess* fBoundaryProcess;
+};
+
+#endif
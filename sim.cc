@@ -3,36 +3,32 @@
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
 #include "G4VisManager.hh"
-#include "PMDetectorConstruction.hh"
-#include "PMPhysicsList.hh"
-#include "PMActionInitialization.hh"
-#include "G4SystemOfUnits.hh"
-#include "G4Threading.hh"
+#include "PMCommandLine.hh"
+#include "PMSetup.hh"
+#include "PMStartupProfiler.hh"
 
 int main(int argc, char** argv) {
-    G4String macroFile = (argc > 1) ? argv[1] : "";
+    PMStartupProfiler::Instance();
+    PMCommandLine options = PMCommandLine::Parse(argc, argv);
+    G4String macroFile = options.macroFile;
 
     G4UIExecutive* ui = nullptr;
-    if (macroFile.empty()) { 
-        ui = new G4UIExecutive(argc, argv); 
+    if (macroFile.empty()) {
+        ui = new G4UIExecutive(argc, argv);
     }
 
-    G4RunManager* runManager = new G4RunManager;
-    
-    if (G4Threading::IsMultithreadedApplication()) {
-        runManager->SetNumberOfThreads(4);
-    }
+    G4RunManager* runManager = PMSetup::CreateRunManager(options);
 
-    G4double energy = 5 * MeV;  
-    runManager->SetUserInitialization(new PMDetectorConstruction());
-    runManager->SetUserInitialization(new PMPhysicsList());
-    runManager->SetUserInitialization(new PMActionInitialization(energy));
-    
-    G4VisManager* visManager = new G4VisExecutive;
-    visManager->Initialize();
+    // Visualization only for the interactive session; macro runs stay
+    // headless (sim_batch does not even link the drivers).
+    G4VisManager* visManager = nullptr;
+    if (ui) {
+        visManager = new G4VisExecutive;
+        visManager->Initialize();
+    }
 
     G4UImanager* UImanager = G4UImanager::GetUIpointer();
-    
+
     if (!macroFile.empty()) {
         UImanager->ApplyCommand("/control/execute " + macroFile);
     } else {
@@ -0,0 +1,45 @@
+// Headless entry point for batch and cluster jobs. Same geometry, physics
+// and actions as sim, but no UI session or visualization manager is ever
+// constructed and the executable links only the Geant4 kernel libraries,
+// so it needs no X/OpenGL on the node. Trajectories are not stored.
+//
+//   sim_batch [macro] [-n|--events N] [sim options]
+//
+// The macro (which must not use /vis/ commands; see macros/batch.mac) is
+// executed first; --events N then runs N more events.
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4StateManager.hh"
+#include "PMCommandLine.hh"
+#include "PMSetup.hh"
+#include "PMStartupProfiler.hh"
+
+int main(int argc, char** argv) {
+    PMStartupProfiler::Instance();
+    PMCommandLine options = PMCommandLine::Parse(argc, argv);
+    if (options.macroFile.empty() && options.nEvents <= 0) {
+        G4cerr << "🚨 ERROR: sim_batch needs a macro and/or --events N" << G4endl;
+        PMCommandLine::PrintUsage(argv[0]);
+        return 1;
+    }
+
+    G4RunManager* runManager = PMSetup::CreateRunManager(options);
+
+    G4UImanager* UImanager = G4UImanager::GetUIpointer();
+    UImanager->ApplyCommand("/tracking/storeTrajectory 0");
+
+    if (!options.macroFile.empty()) {
+        UImanager->ApplyCommand("/control/macroPath ./macros");
+        UImanager->ApplyCommand("/control/execute " + options.macroFile);
+    }
+    if (options.nEvents > 0) {
+        if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_PreInit) {
+            runManager->Initialize();
+        }
+        runManager->BeamOn(options.nEvents);
+    }
+
+    delete runManager;
+    return 0;
+}
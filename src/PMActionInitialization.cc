@@ -1,6 +1,11 @@
 #include "PMActionInitialization.hh"
 #include "PMPrimaryGenerator.hh"
 #include "PMRunAction.hh"
+#include "PMEventAction.hh"
+#include "PMSteppingAction.hh"
+#include "PMStackingAction.hh"
+#include "PMDigitizer.hh"
+#include "G4DigiManager.hh"
 #include "G4SystemOfUnits.hh"  
 
 PMActionInitialization::PMActionInitialization(G4double energy)
@@ -12,7 +17,22 @@ void PMActionInitialization::BuildForMaster() const {
     SetUserAction(new PMRunAction(fEnergy));  
 }
 
+// Called once per worker thread (or once in sequential mode): every action
+// built here, and the sensitive detectors from ConstructSDandField, are
+// thread-private. Only PMRunAction's accumulables cross threads, at run end.
 void PMActionInitialization::Build() const {
     SetUserAction(new PMPrimaryGenerator(fEnergy)); 
-    SetUserAction(new PMRunAction(fEnergy));    
+
+    auto* runAction = new PMRunAction(fEnergy);
+    SetUserAction(runAction);
+
+    auto* eventAction = new PMEventAction(runAction);
+    SetUserAction(eventAction);
+    auto* stackingAction = new PMStackingAction(eventAction);
+    SetUserAction(stackingAction);
+    SetUserAction(new PMSteppingAction(eventAction, stackingAction));
+
+    // The digi manager is per thread; the module only runs when the event
+    // action asks for it (/PM/digi/enable).
+    G4DigiManager::GetDMpointer()->AddNewModule(new PMDigitizer());
 }
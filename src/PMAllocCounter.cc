@@ -0,0 +1,156 @@
+#include "PMAllocCounter.hh"
+#include "PMLog.hh"
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+namespace {
+// Constant-initialized, so touching it from operator new never allocates.
+struct ThreadCounters {
+    G4long allocations[PMAllocCounter::kScopes];
+    G4long bytes[PMAllocCounter::kScopes];
+    G4int scope;
+};
+
+G4ThreadLocal ThreadCounters counters = {};
+G4ThreadLocal ThreadCounters eventStart = {};
+G4ThreadLocal PMAllocCounter::Totals* threadTotals = nullptr;
+
+const char* const kScopeNames[PMAllocCounter::kScopes] = {
+    "geant4", "primary", "stepping", "stacking", "sensitive", "event", "digitizer"};
+}
+
+#ifdef PM_ALLOC_COUNTING
+void* operator new(std::size_t size) {
+    ++counters.allocations[counters.scope];
+    counters.bytes[counters.scope] += static_cast<G4long>(size);
+    if (size == 0) {
+        size = 1;
+    }
+    for (;;) {
+        if (void* p = std::malloc(size)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+#endif
+
+PMAllocCounter* PMAllocCounter::Instance() {
+    static PMAllocCounter* instance = new PMAllocCounter();
+    return instance;
+}
+
+PMAllocCounter::PMAllocCounter() {}
+
+const char* PMAllocCounter::GetScopeName(G4int scope) {
+    return (scope >= 0 && scope < kScopes) ? kScopeNames[scope] : "?";
+}
+
+G4int PMAllocCounter::Enter(PMAllocScope scope) {
+    const G4int previous = counters.scope;
+    counters.scope = static_cast<G4int>(scope);
+    return previous;
+}
+
+void PMAllocCounter::Leave(G4int previous) {
+    counters.scope = previous;
+}
+
+void PMAllocCounter::BeginOfRun() {
+    fMerged = Totals();
+}
+
+void PMAllocCounter::BeginOfThreadRun() {
+    if (!IsCompiledIn()) {
+        return;
+    }
+    if (!threadTotals) {
+        threadTotals = new Totals();
+    }
+    *threadTotals = Totals();
+    eventStart = counters;
+}
+
+void PMAllocCounter::EndOfEvent() {
+    if (!threadTotals) {
+        return;
+    }
+    for (G4int s = 0; s < kScopes; ++s) {
+        const G4long allocations = counters.allocations[s] - eventStart.allocations[s];
+        threadTotals->allocations[s] += allocations;
+        threadTotals->bytes[s] += counters.bytes[s] - eventStart.bytes[s];
+        threadTotals->maxEventAllocations[s] = std::max(threadTotals->maxEventAllocations[s], allocations);
+    }
+    ++threadTotals->events;
+    eventStart = counters;
+}
+
+void PMAllocCounter::MergeThreadTotals() {
+    if (!threadTotals) {
+        return;
+    }
+    G4AutoLock lock(&fMergeMutex);
+    fMerged.events += threadTotals->events;
+    for (G4int s = 0; s < kScopes; ++s) {
+        fMerged.allocations[s] += threadTotals->allocations[s];
+        fMerged.bytes[s] += threadTotals->bytes[s];
+        fMerged.maxEventAllocations[s] = std::max(fMerged.maxEventAllocations[s],
+                                                  threadTotals->maxEventAllocations[s]);
+    }
+}
+
+void PMAllocCounter::EndOfRun() {
+    if (!IsCompiledIn() || fMerged.events == 0) {
+        return;
+    }
+    const G4double events = fMerged.events;
+    G4long userAllocations = 0;
+    std::ostringstream table;
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-10s %14s %14s %12s\n", "scope", "allocs/event", "bytes/event",
+                  "max allocs");
+    table << line;
+    for (G4int s = 0; s < kScopes; ++s) {
+        std::snprintf(line, sizeof(line), "%-10s %14.1f %14.0f %12ld\n", kScopeNames[s],
+                      fMerged.allocations[s] / events, fMerged.bytes[s] / events,
+                      static_cast<long>(fMerged.maxEventAllocations[s]));
+        table << line;
+        if (s != static_cast<G4int>(PMAllocScope::kGeant4)) {
+            userAllocations += fMerged.allocations[s];
+        }
+    }
+    PM_SUMMARY("\n====== Heap allocations (" << fMerged.events << " events) ======\n"
+               << table.str()
+               << "👤 User callbacks: " << userAllocations / events << " allocations/event\n"
+               << "==========================================");
+}
@@ -0,0 +1,190 @@
+#include "PMColumnarWriter.hh"
+#include "G4Exception.hh"
+
+#include <chrono>
+#include <cstring>
+
+#ifdef PM_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+PMColumnarWriter::PMColumnarWriter()
+    : fCurrent(nullptr), fStop(false), fFile(nullptr), fRowsPerChunk(0), fCompress(false) {}
+
+PMColumnarWriter::~PMColumnarWriter() {
+    Close();
+}
+
+G4int PMColumnarWriter::AddColumn(const G4String& name, PMColumnar::ColumnType type) {
+    PMColumnar::ColumnDesc desc{};
+    std::strncpy(desc.name, name.c_str(), PMColumnar::kNameLength - 1);
+    desc.type = type;
+    fColumns.push_back(desc);
+    return static_cast<G4int>(fColumns.size()) - 1;
+}
+
+G4bool PMColumnarWriter::Open(const G4String& fileName, G4int rowsPerChunk, G4bool compress) {
+    Close();
+
+    fFile = std::fopen(fileName.c_str(), "wb");
+    if (!fFile) {
+        G4ExceptionDescription msg;
+        msg << "Cannot open columnar output " << fileName;
+        G4Exception("PMColumnarWriter::Open", "PMOutput001", JustWarning, msg);
+        return false;
+    }
+
+#ifndef PM_HAVE_ZLIB
+    if (compress) {
+        G4Exception("PMColumnarWriter::Open", "PMOutput002", JustWarning,
+                    "Built without zlib; writing uncompressed chunks.");
+        compress = false;
+    }
+#endif
+    fCompress = compress;
+    fRowsPerChunk = rowsPerChunk;
+
+    PMColumnar::FileHeader header{};
+    std::memcpy(header.magic, PMColumnar::kFileMagic, sizeof(header.magic));
+    header.nColumns = static_cast<std::uint32_t>(fColumns.size());
+    std::fwrite(&header, sizeof(header), 1, fFile);
+    std::fwrite(fColumns.data(), sizeof(PMColumnar::ColumnDesc), fColumns.size(), fFile);
+
+    fPool.assign(kChunkPool, Chunk());
+    for (Chunk& chunk : fPool) {
+        chunk.columns.resize(fColumns.size());
+        for (std::size_t i = 0; i < fColumns.size(); ++i) {
+            chunk.columns[i].resize(fRowsPerChunk * PMColumnar::TypeSize(fColumns[i].type));
+        }
+        fFree.Push(&chunk);
+    }
+    fFree.Pop(fCurrent);
+
+    fStop.store(false, std::memory_order_relaxed);
+    fThread = std::thread(&PMColumnarWriter::WriterLoop, this);
+    return true;
+}
+
+void PMColumnarWriter::Close() {
+    if (!fFile) {
+        return;
+    }
+    if (fCurrent && fCurrent->nRows > 0) {
+        Submit(fCurrent);
+        fCurrent = nullptr;
+    }
+    fStop.store(true, std::memory_order_release);
+    fThread.join();
+
+    std::fclose(fFile);
+    fFile = nullptr;
+    fCurrent = nullptr;
+    Chunk* chunk = nullptr;
+    while (fFree.Pop(chunk)) {}
+    fPool.clear();
+}
+
+void PMColumnarWriter::Store(G4int column, const void* value, std::size_t size) {
+    std::memcpy(fCurrent->columns[column].data() + fCurrent->nRows * size, value, size);
+}
+
+void PMColumnarWriter::AddRow() {
+    if (++fCurrent->nRows == fRowsPerChunk) {
+        Submit(fCurrent);
+        fCurrent = Acquire();
+    }
+}
+
+void PMColumnarWriter::Submit(Chunk* chunk) {
+    while (!fFull.Push(chunk)) {
+        std::this_thread::yield();
+    }
+}
+
+PMColumnarWriter::Chunk* PMColumnarWriter::Acquire() {
+    Chunk* chunk = nullptr;
+    while (!fFree.Pop(chunk)) {
+        std::this_thread::yield();
+    }
+    chunk->nRows = 0;
+    return chunk;
+}
+
+void PMColumnarWriter::WriterLoop() {
+    Chunk* chunk = nullptr;
+    for (;;) {
+        if (fFull.Pop(chunk)) {
+            WriteChunk(*chunk);
+            fFree.Push(chunk);
+        } else if (fStop.load(std::memory_order_acquire)) {
+            // Anything submitted before the stop flag is visible now.
+            while (fFull.Pop(chunk)) {
+                WriteChunk(*chunk);
+                fFree.Push(chunk);
+            }
+            break;
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    std::fflush(fFile);
+}
+
+void PMColumnarWriter::WriteChunk(const Chunk& chunk) {
+    const std::size_t nColumns = fColumns.size();
+
+    std::vector<PMColumnar::ColumnBlock> blocks(nColumns);
+    std::size_t staged = 0;
+    if (!StageChunk(chunk, blocks, staged)) {
+        // The codec is per chunk, so this one is staged again uncompressed,
+        // and so is the rest of the file.
+        G4Exception("PMColumnarWriter::WriteChunk", "PMOutput002", JustWarning,
+                    "zlib compression failed; writing uncompressed chunks.");
+        fCompress = false;
+        StageChunk(chunk, blocks, staged);
+    }
+
+    PMColumnar::ChunkHeader header{};
+    header.magic = PMColumnar::kChunkMagic;
+    header.nRows = static_cast<std::uint32_t>(chunk.nRows);
+    header.codec = fCompress ? PMColumnar::kZlib : PMColumnar::kRaw;
+    header.nColumns = static_cast<std::uint32_t>(nColumns);
+
+    std::fwrite(&header, sizeof(header), 1, fFile);
+    std::fwrite(blocks.data(), sizeof(PMColumnar::ColumnBlock), nColumns, fFile);
+    std::fwrite(fCompressBuffer.data(), 1, staged, fFile);
+}
+
+G4bool PMColumnarWriter::StageChunk(const Chunk& chunk, std::vector<PMColumnar::ColumnBlock>& blocks,
+                                    std::size_t& staged) {
+    // Payloads are staged back to back in fCompressBuffer so the whole chunk
+    // goes out in a few fwrite calls.
+    staged = 0;
+    for (std::size_t i = 0; i < fColumns.size(); ++i) {
+        const std::size_t rawBytes = chunk.nRows * PMColumnar::TypeSize(fColumns[i].type);
+        const unsigned char* raw = reinterpret_cast<const unsigned char*>(chunk.columns[i].data());
+        std::size_t storedBytes = rawBytes;
+
+#ifdef PM_HAVE_ZLIB
+        if (fCompress) {
+            uLongf bound = compressBound(rawBytes);
+            fCompressBuffer.resize(staged + PMColumnar::Padded(bound));
+            if (compress2(fCompressBuffer.data() + staged, &bound, raw, rawBytes, 1) != Z_OK) {
+                return false;
+            }
+            storedBytes = bound;
+        } else
+#endif
+        {
+            fCompressBuffer.resize(staged + PMColumnar::Padded(rawBytes));
+            std::memcpy(fCompressBuffer.data() + staged, raw, rawBytes);
+        }
+
+        const std::size_t padded = PMColumnar::Padded(storedBytes);
+        std::memset(fCompressBuffer.data() + staged + storedBytes, 0, padded - storedBytes);
+        blocks[i].rawBytes = rawBytes;
+        blocks[i].storedBytes = storedBytes;
+        staged += padded;
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+#include "PMCommandLine.hh"
+#include "G4Threading.hh"
+#include "PMShard.hh"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+G4int ParseThreadCount(const char* value) {
+    G4int n = std::atoi(value);
+    return (n > 0) ? n : G4Threading::G4GetNumberOfCores();
+}
+
+void ParseShard(const char* value, PMCommandLine& options, const char* program) {
+    if (!PMShard::Parse(value, options.shardIndex, options.shardCount)) {
+        G4cerr << "🚨 ERROR: invalid shard " << value << " (expected i/N with 0 <= i < N)" << G4endl;
+        PMCommandLine::PrintUsage(program);
+        std::exit(1);
+    }
+}
+}
+
+PMCommandLine PMCommandLine::Parse(int argc, char** argv) {
+    PMCommandLine options;
+
+    if (const char* env = std::getenv("PM_NUM_THREADS")) {
+        options.nThreads = ParseThreadCount(env);
+    }
+    if (const char* env = std::getenv("PM_PHYSICS")) {
+        options.physics = env;
+    }
+    if (const char* env = std::getenv("PM_TABLE_CACHE")) {
+        options.tableCache = env;
+    }
+    if (const char* env = std::getenv("PM_SEED")) {
+        options.seed = std::atol(env);
+    }
+    if (const char* env = std::getenv("PM_SHARD")) {
+        ParseShard(env, options, argv[0]);
+    }
+
+    for (G4int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if ((!std::strcmp(arg, "-t") || !std::strcmp(arg, "--threads")) && i + 1 < argc) {
+            options.nThreads = ParseThreadCount(argv[++i]);
+        } else if ((!std::strcmp(arg, "-p") || !std::strcmp(arg, "--physics")) && i + 1 < argc) {
+            options.physics = argv[++i];
+        } else if (!std::strcmp(arg, "--table-cache") && i + 1 < argc) {
+            options.tableCache = argv[++i];
+        } else if ((!std::strcmp(arg, "-n") || !std::strcmp(arg, "--events")) && i + 1 < argc) {
+            options.nEvents = std::atoi(argv[++i]);
+        } else if (!std::strcmp(arg, "--seed") && i + 1 < argc) {
+            options.seed = std::atol(argv[++i]);
+        } else if (!std::strcmp(arg, "--shard") && i + 1 < argc) {
+            ParseShard(argv[++i], options, argv[0]);
+        } else if (!std::strcmp(arg, "-h") || !std::strcmp(arg, "--help")) {
+            PrintUsage(argv[0]);
+            std::exit(0);
+        } else if (arg[0] != '-' && options.macroFile.empty()) {
+            options.macroFile = arg;
+        } else {
+            G4cerr << "🚨 ERROR: unknown option " << arg << G4endl;
+            PrintUsage(argv[0]);
+            std::exit(1);
+        }
+    }
+
+    if (options.nThreads <= 0) {
+        options.nThreads = G4Threading::G4GetNumberOfCores();
+    }
+    return options;
+}
+
+void PMCommandLine::PrintUsage(const char* program) {
+    G4cout << "Usage: " << program << " [macro] [options]\n"
+           << "  -t, --threads N   number of worker threads (env PM_NUM_THREADS, default: all cores)\n"
+           << "  -p, --physics P   physics list: full or lean (env PM_PHYSICS, default: full)\n"
+           << "  --table-cache DIR store/retrieve physics tables in DIR (env PM_TABLE_CACHE)\n"
+           << "  -n, --events N    sim_batch: run N events after the macro\n"
+           << "  --seed S          reseed every event from master seed S (env PM_SEED, 0: off)\n"
+           << "  --shard i/N       run shard i of N; each shard runs the macro's event count\n"
+           << "                    and writes <stem>_shard<i>.* (env PM_SHARD)\n"
+           << "  -h, --help        show this message" << G4endl;
+}
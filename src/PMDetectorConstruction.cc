@@ -1,6 +1,16 @@
 #include "PMDetectorConstruction.hh"
 #include "PMSensitiveDetector.hh"
+#include "PMVolumeRegistry.hh"
+#include "PMOpticalResponse.hh"
+#include "PMScoringMesh.hh"
+#include "PMDetectorMessenger.hh"
+#include "PMFastScintillatorModel.hh"
+#include "PMMaterialData.hh"
+#include "PMEmissionSpectrum.hh"
+#include "G4RunManager.hh"
 #include "G4SDManager.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
 #include "G4NistManager.hh"
 #include "G4Box.hh"
 #include "G4LogicalVolume.hh"
@@ -10,38 +20,93 @@
 #include "G4OpticalSurface.hh"
 #include "G4LogicalBorderSurface.hh"
 #include "G4SubtractionSolid.hh"
+#include "PMLog.hh"
+#include "PMStartupProfiler.hh"
+
+#include <algorithm>
+
+G4ThreadLocal PMFastScintillatorModel* PMDetectorConstruction::fFastModel = nullptr;
+
+PMDetectorConstruction::PMDetectorConstruction()
+    : fScintillatorSize(10.0 * cm, 10.0 * cm, 3.0 * cm),
+      fTeflonThickness(0.01 * cm),
+      fHoleSize(5.0 * mm),
+      fTeflonReflectivity(0.99),
+      fAluminumThickness(0.),
+      fWorldSize(50.0 * cm),
+      fArrayNx(1),
+      fArrayNy(1),
+      fModuleGap(1.0 * mm),
+      fTeflonSurfaceMPT(nullptr),
+      fMessenger(new PMDetectorMessenger(this)) {}
+
+PMDetectorConstruction::~PMDetectorConstruction() {
+    delete fMessenger;
+}
 
-PMDetectorConstruction::PMDetectorConstruction() {}
-PMDetectorConstruction::~PMDetectorConstruction() {}
+void PMDetectorConstruction::SetScintillatorSize(const G4ThreeVector& size) {
+    fScintillatorSize = size;
+    G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
 
-G4Material* PMDetectorConstruction::CreateScintillatorMaterial() {
-    G4NistManager* nist = G4NistManager::Instance();
-    G4Material* NaI = nist->FindOrBuildMaterial("G4_SODIUM_IODIDE");
+void PMDetectorConstruction::SetTeflonThickness(G4double thickness) {
+    fTeflonThickness = thickness;
+    G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
+
+void PMDetectorConstruction::SetHoleSize(G4double size) {
+    fHoleSize = size;
+    G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
 
-    G4MaterialPropertiesTable* scintMPT = new G4MaterialPropertiesTable();
+void PMDetectorConstruction::SetAluminumThickness(G4double thickness) {
+    fAluminumThickness = thickness;
+    G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
 
-    std::vector<G4double> photonEnergies = {
-        1.5 * eV, 1.8 * eV, 2.034 * eV, 2.068 * eV, 2.103 * eV, 2.139 * eV, 
-        2.177 * eV, 2.216 * eV, 2.256 * eV, 2.298 * eV, 2.341 * eV, 2.386 * eV, 2.481 * eV, 3.0 * eV
-    };  
+void PMDetectorConstruction::SetWorldSize(G4double size) {
+    fWorldSize = size;
+    G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
 
-    std::vector<G4double> rindex(photonEnergies.size(), 1.65);
-    scintMPT->AddProperty("RINDEX", photonEnergies.data(), rindex.data(), photonEnergies.size());
+void PMDetectorConstruction::SetArraySize(G4int nx, G4int ny) {
+    fArrayNx = nx;
+    fArrayNy = ny;
+    G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
 
-    std::vector<G4double> scintil = { 
-        0.02, 0.07, 0.15, 0.32, 0.57, 0.85, 1.00, 0.85, 0.57, 0.32, 0.15, 0.07 
-    };
-    scintMPT->AddProperty("FASTCOMPONENT", photonEnergies.data(), scintil.data(), photonEnergies.size(), true);
+void PMDetectorConstruction::SetModuleGap(G4double gap) {
+    fModuleGap = gap;
+    G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
 
-    std::vector<G4double> absorption(photonEnergies.size(), 800.*cm);
-    scintMPT->AddProperty("ABSLENGTH", photonEnergies.data(), absorption.data(), photonEnergies.size());
+// The boundary process reads the surface table on every step, so updating
+// the property in place takes effect on the next run without rebuilding
+// geometry or physics tables.
+void PMDetectorConstruction::SetTeflonReflectivity(G4double reflectivity) {
+    fTeflonReflectivity = reflectivity;
+    if (fTeflonSurfaceMPT) {
+        std::vector<G4double> teflonReflectivity(fTeflonEnergies.size(), fTeflonReflectivity);
+        fTeflonSurfaceMPT->RemoveProperty("REFLECTIVITY");
+        fTeflonSurfaceMPT->AddProperty("REFLECTIVITY", fTeflonEnergies, teflonReflectivity);
+    }
+}
 
-    scintMPT->AddConstProperty("SCINTILLATIONYIELD", 100000. / MeV, true);
-    scintMPT->AddConstProperty("RESOLUTIONSCALE", 1.5, true);
-    scintMPT->AddConstProperty("FASTTIMECONSTANT", 200.*ns, true);
-    scintMPT->AddConstProperty("YIELDRATIO", 1.0, true);
+// Bulk properties come from data/*.dat (PMMaterialData); Construct runs on
+// the master only, so the tables and the emission sampler are shared
+// read-only by the workers. They do not depend on any /PM/det/ parameter:
+// they are built on the first construction and kept across geometry
+// rebuilds instead of being replaced (and leaked) every time.
+G4Material* PMDetectorConstruction::CreateScintillatorMaterial() {
+    G4NistManager* nist = G4NistManager::Instance();
+    G4Material* NaI = nist->FindOrBuildMaterial("G4_SODIUM_IODIDE");
+    if (NaI->GetMaterialPropertiesTable()) {
+        return NaI;
+    }
 
-    NaI->SetMaterialPropertiesTable(scintMPT);
+    const PMMaterialData data = PMMaterialData::Load("NaI_Tl.dat");
+    NaI->SetMaterialPropertiesTable(data.FillPropertiesTable());
+    PMEmissionSpectrum::Build(NaI, data.GetEnergies(), data.GetProperty("SCINTILLATIONCOMPONENT1"));
     return NaI;
 }
 
@@ -53,13 +118,9 @@ G4Material* PMDetectorConstruction::CreateTeflonMaterial() {
 G4Material* PMDetectorConstruction::CreateAluminumMaterial() {
     G4NistManager* nist = G4NistManager::Instance();
     G4Material* aluminum = nist->FindOrBuildMaterial("G4_Al");
-
-    G4MaterialPropertiesTable* alMPT = new G4MaterialPropertiesTable();
-    std::vector<G4double> photonEnergies = {1.0*eV, 6.0*eV};
-    std::vector<G4double> absorptionLength = {1*mm, 1*mm};
-    alMPT->AddProperty("ABSLENGTH", photonEnergies.data(), absorptionLength.data(), photonEnergies.size());
-    aluminum->SetMaterialPropertiesTable(alMPT);
-
+    if (!aluminum->GetMaterialPropertiesTable()) {
+        aluminum->SetMaterialPropertiesTable(PMMaterialData::Load("Aluminum.dat").FillPropertiesTable());
+    }
     return aluminum;
 }
 
@@ -77,13 +138,16 @@ void PMDetectorConstruction::DefineOpticalSurfaces(G4VPhysicalVolume* scintillat
     teflonSurface->SetFinish(groundfrontpainted);
     teflonSurface->SetModel(unified);
 
-    G4MaterialPropertiesTable* teflonMPT = new G4MaterialPropertiesTable();
-    std::vector<G4double> teflonEnergy = {1.0 * eV, 6.0 * eV};
-    std::vector<G4double> teflonReflectivity = {0.99, 0.99};
-    std::vector<G4double> teflonEfficiency  = {0.0,  0.0};
-    teflonMPT->AddProperty("REFLECTIVITY", teflonEnergy.data(), teflonReflectivity.data(), teflonEnergy.size());
-    teflonMPT->AddProperty("EFFICIENCY",   teflonEnergy.data(), teflonEfficiency.data(),   teflonEnergy.size());
+    // A geometry rebuild has already deleted the previous surface, which
+    // does not own its table.
+    delete fTeflonSurfaceMPT;
+    const PMMaterialData data = PMMaterialData::Load("Teflon_surface.dat");
+    fTeflonEnergies = data.GetEnergies();
+    G4MaterialPropertiesTable* teflonMPT = data.FillPropertiesTable();
+    std::vector<G4double> teflonReflectivity(fTeflonEnergies.size(), fTeflonReflectivity);
+    teflonMPT->AddProperty("REFLECTIVITY", fTeflonEnergies, teflonReflectivity);
     teflonSurface->SetMaterialPropertiesTable(teflonMPT);
+    fTeflonSurfaceMPT = teflonMPT;
 
     new G4LogicalBorderSurface("TeflonLeftSurface",  scintillatorPhys, teflonLeftPhys,  teflonSurface);
     new G4LogicalBorderSurface("TeflonRightSurface", scintillatorPhys, teflonRightPhys, teflonSurface);
@@ -93,37 +157,65 @@ void PMDetectorConstruction::DefineOpticalSurfaces(G4VPhysicalVolume* scintillat
 }
 
 G4VPhysicalVolume* PMDetectorConstruction::Construct() {
-    G4double worldSize = 50.0 * cm;
-    G4Box* worldBox = new G4Box("World", worldSize/2, worldSize/2, worldSize/2);
+    PMStartupScope profile("geometry");
     G4Material* air = G4NistManager::Instance()->FindOrBuildMaterial("G4_AIR");
-    G4LogicalVolume* worldLV = new G4LogicalVolume(worldBox, air, "World");
-    G4VPhysicalVolume* worldPhys = new G4PVPlacement(nullptr, G4ThreeVector(),
-                                                     worldLV, "World", nullptr, false, 0);
-
     G4Material* scintMaterial   = CreateScintillatorMaterial();
     G4Material* teflonMaterial  = CreateTeflonMaterial();
     G4Material* aluminumMaterial= CreateAluminumMaterial(); 
 
-    G4double scintX = 10.0 * cm;
-    G4double scintY = 10.0 * cm;
-    G4double scintZ = 3.0  * cm;
+    G4double scintX = fScintillatorSize.x();
+    G4double scintY = fScintillatorSize.y();
+    G4double scintZ = fScintillatorSize.z();
+    G4double teflonThickness = fTeflonThickness;
+    G4double aluminumThickness = (fAluminumThickness > 0.) ? fAluminumThickness : teflonThickness * 1.2;
+
+    // Module envelope: just large enough for the wrapped crystal and the
+    // aluminum plate, which sits on the crystal's -x face and sticks out of
+    // the Teflon wall when thicker than it.
+    G4ThreeVector moduleHalf(scintX/2 + std::max(teflonThickness, aluminumThickness),
+                             scintY/2 + teflonThickness,
+                             scintZ/2 + teflonThickness);
+    G4Box* moduleBox = new G4Box("Module", moduleHalf.x(), moduleHalf.y(), moduleHalf.z());
+    moduleLogical = new G4LogicalVolume(moduleBox, air, "Module");
+
+    G4double pitchX = 2 * moduleHalf.x() + fModuleGap;
+    G4double pitchY = 2 * moduleHalf.y() + fModuleGap;
+    G4double margin = 5.0 * cm;
+    G4double worldHalfX = std::max(fWorldSize/2, fArrayNx * pitchX / 2 + margin);
+    G4double worldHalfY = std::max(fWorldSize/2, fArrayNy * pitchY / 2 + margin);
+    G4double worldHalfZ = std::max(fWorldSize/2, moduleHalf.z() + margin);
+    G4Box* worldBox = new G4Box("World", worldHalfX, worldHalfY, worldHalfZ);
+    G4LogicalVolume* worldLV = new G4LogicalVolume(worldBox, air, "World");
+    G4VPhysicalVolume* worldPhys = new G4PVPlacement(nullptr, G4ThreeVector(),
+                                                     worldLV, "World", nullptr, false, 0);
+
     G4Box* scintBox = new G4Box("Scintillator", scintX/2, scintY/2, scintZ/2);
     scintillatorLogical = new G4LogicalVolume(scintBox, scintMaterial, "Scintillator");
+    PMOpticalResponse::Instance()->SetCrystalHalfSize(G4ThreeVector(scintX/2, scintY/2, scintZ/2));
+    PMScoringMesh::Instance()->SetCrystalHalfSize(G4ThreeVector(scintX/2, scintY/2, scintZ/2));
+
+    // The region outlives geometry rebuilds, so the fast-simulation model
+    // bound to it in ConstructSDandField does too.
+    G4Region* scintillatorRegion = G4RegionStore::GetInstance()->GetRegion("ScintillatorRegion", false);
+    if (!scintillatorRegion) {
+        scintillatorRegion = new G4Region("ScintillatorRegion");
+    }
+    scintillatorRegion->AddRootLogicalVolume(scintillatorLogical);
 
     G4VPhysicalVolume* scintillatorPhys = new G4PVPlacement(
         nullptr, G4ThreeVector(0, 0, 0),
-        scintillatorLogical, "ScintillatorPhys", worldLV, false, 0);
-
-    G4double teflonThickness = 0.01 * cm;
+        scintillatorLogical, "ScintillatorPhys", moduleLogical, false, 0);
 
     G4Box* teflonX   = new G4Box("TeflonX",   teflonThickness/2, scintY/2,    scintZ/2);
     G4Box* teflonY   = new G4Box("TeflonY",   scintX/2,          teflonThickness/2, scintZ/2);
     G4Box* teflonTop = new G4Box("TeflonTop", scintX/2,          scintY/2,    teflonThickness/2);
 
-    G4double holeSize = 5.0 * mm;
-    G4Box* holeBox = new G4Box("Hole", teflonThickness/2, holeSize/2, holeSize/2);
+    G4double holeSize = fHoleSize;
+    // Cut through the whole wall (the box is twice as thick as the Teflon so
+    // no face of the subtraction is coincident) for the plate to sit in.
+    G4Box* holeBox = new G4Box("Hole", teflonThickness, holeSize/2, holeSize/2);
 
-    G4ThreeVector holePosition(-(teflonThickness/2), 0, 0);
+    G4ThreeVector holePosition(0, 0, 0);
     G4SubtractionSolid* teflonLeftWithHole = new G4SubtractionSolid(
         "TeflonX_Left_Hole", teflonX, holeBox, nullptr, holePosition);
 
@@ -135,42 +227,68 @@ G4VPhysicalVolume* PMDetectorConstruction::Construct() {
 
     teflonFrontPhys = new G4PVPlacement(
         nullptr, G4ThreeVector(0,  (scintY/2 + teflonThickness/2), 0),
-        teflonFrontLogical, "TeflonY_Front", worldLV, false, 0);
+        teflonFrontLogical, "TeflonY_Front", moduleLogical, false, 0);
 
     teflonBackPhys  = new G4PVPlacement(
         nullptr, G4ThreeVector(0, -(scintY/2 + teflonThickness/2), 0),
-        teflonBackLogical, "TeflonY_Back", worldLV, false, 1);
+        teflonBackLogical, "TeflonY_Back", moduleLogical, false, 1);
 
     teflonLeftPhys  = new G4PVPlacement(
         nullptr, G4ThreeVector(-(scintX/2 + teflonThickness/2), 0, 0),
-        teflonLeftLogical, "TeflonX_Left", worldLV, false, 2);
+        teflonLeftLogical, "TeflonX_Left", moduleLogical, false, 2);
 
     teflonRightPhys = new G4PVPlacement(
         nullptr, G4ThreeVector((scintX/2 + teflonThickness/2), 0, 0),
-        teflonRightLogical, "TeflonX_Right", worldLV, false, 3);
+        teflonRightLogical, "TeflonX_Right", moduleLogical, false, 3);
 
     teflonTopPhys   = new G4PVPlacement(
         nullptr, G4ThreeVector(0, 0, scintZ/2 + teflonThickness/2),
-        teflonTopLogical, "TeflonTop", worldLV, false, 4);
+        teflonTopLogical, "TeflonTop", moduleLogical, false, 4);
 
-    G4cout << "🔍 Debug: Creating Teflon hole with size = "
-           << holeSize/mm << " mm at " << holePosition << G4endl;
+    PM_DEBUG("🔍 Debug: Creating Teflon hole with size = "
+             << holeSize/mm << " mm at " << holePosition);
 
-    G4double aluminumThickness = teflonThickness * 1.2;
     G4Box* aluminumPlate = new G4Box("AluminumPlate",
                                      aluminumThickness/2, holeSize/2, holeSize/2);
 
     aluminumLogical = new G4LogicalVolume(aluminumPlate, aluminumMaterial, "AluminumPlate");
 
-    G4ThreeVector aluminumPosition(-(scintX/2 + teflonThickness/2), 0, 0);
+    G4ThreeVector aluminumPosition(-(scintX/2 + aluminumThickness/2), 0, 0);
     aluminumPhys = new G4PVPlacement(
         nullptr, aluminumPosition,
-        aluminumLogical, "AluminumPlate", worldLV, false, 5);
-
-    G4cout << "🔍 Debug: Teflon Hole - Position: " << holePosition
-           << " Size: " << holeSize/mm << " mm" << G4endl;
-    G4cout << "🔍 Debug: Aluminum Position: " << aluminumPosition
-           << " (Same as Hole)" << G4endl;
+        aluminumLogical, "AluminumPlate", moduleLogical, false, 5);
+
+    PM_DEBUG("🔍 Debug: Teflon Hole - Position: " << holePosition
+             << " Size: " << holeSize/mm << " mm");
+    PM_DEBUG("🔍 Debug: Aluminum Position: " << aluminumPosition
+             << " (flush with the crystal, in the hole)");
+
+    // Every copy shares the module's logical volume and daughters, so the
+    // border surfaces below apply to all of them and a module costs one
+    // G4PVPlacement. The world's smart voxels keep navigation local.
+    for (G4int iy = 0; iy < fArrayNy; ++iy) {
+        for (G4int ix = 0; ix < fArrayNx; ++ix) {
+            G4ThreeVector position((ix - 0.5 * (fArrayNx - 1)) * pitchX,
+                                   (iy - 0.5 * (fArrayNy - 1)) * pitchY, 0);
+            new G4PVPlacement(nullptr, position, moduleLogical, "Module", worldLV, false,
+                              iy * fArrayNx + ix);
+        }
+    }
+    PM_DEBUG("🔍 Debug: " << fArrayNx << " x " << fArrayNy << " modules, pitch "
+             << pitchX/mm << " x " << pitchY/mm << " mm");
+
+    PMVolumeRegistry* registry = PMVolumeRegistry::Instance();
+    registry->Clear();
+    registry->Register(worldLV, PMVolumeID::kWorld);
+    registry->Register(moduleLogical, PMVolumeID::kModule);
+    registry->SetModuleCount(fArrayNx * fArrayNy);
+    registry->Register(scintillatorLogical, PMVolumeID::kScintillator);
+    registry->Register(teflonLeftLogical, PMVolumeID::kTeflon);
+    registry->Register(teflonRightLogical, PMVolumeID::kTeflon);
+    registry->Register(teflonFrontLogical, PMVolumeID::kTeflon);
+    registry->Register(teflonBackLogical, PMVolumeID::kTeflon);
+    registry->Register(teflonTopLogical, PMVolumeID::kTeflon);
+    registry->Register(aluminumLogical, PMVolumeID::kAluminum);
 
     DefineOpticalSurfaces(scintillatorPhys, worldPhys, aluminumPhys,
                           teflonLeftPhys, teflonRightPhys, teflonTopPhys,
@@ -195,33 +313,48 @@ G4VPhysicalVolume* PMDetectorConstruction::Construct() {
     teflonTopLogical->SetVisAttributes(teflonVis);
     aluminumLogical->SetVisAttributes(aluminumVis);
     scintillatorLogical->SetVisAttributes(scintVis);
+    moduleLogical->SetVisAttributes(G4VisAttributes::GetInvisible());
 
     return worldPhys;
 }
 
 void PMDetectorConstruction::ConstructSDandField() {
+    PMStartupScope profile("sensitive detectors");
     G4SDManager* sdManager = G4SDManager::GetSDMpointer();
 
     if (!scintillatorLogical) {
         G4cerr << "🚨 ERROR: scintillatorLogical is NULL! " << G4endl;
         return;
     }
-    PMSensitiveDetector* scintSD = new PMSensitiveDetector("ScintillatorSD");
-    sdManager->AddNewDetector(scintSD);
-    scintillatorLogical->SetSensitiveDetector(scintSD);
-
     if (!aluminumLogical) {
         G4cerr << "🚨 ERROR: aluminumLogical is NULL! " << G4endl;
         return;
     }
-    PMSensitiveDetector* aluminumSD = new PMSensitiveDetector("AluminumSD");
-    sdManager->AddNewDetector(aluminumSD);
-    aluminumLogical->SetSensitiveDetector(aluminumSD);
+    // One detector for the crystal and the window, so every hit goes
+    // through the same counting path. Called again after every geometry
+    // change: reuse this thread's SD.
+    G4VSensitiveDetector* moduleSD = sdManager->FindSensitiveDetector("ModuleSD", false);
+    if (!moduleSD) {
+        moduleSD = new PMSensitiveDetector("ModuleSD");
+        sdManager->AddNewDetector(moduleSD);
+    }
+    scintillatorLogical->SetSensitiveDetector(moduleSD);
+    aluminumLogical->SetSensitiveDetector(moduleSD);
+
+    // One model per thread; it stays idle unless /PM/fastsim/enable is set.
+    // Its hit maker navigates the world it was created in, so it is
+    // renewed with every geometry.
+    if (!fFastModel) {
+        fFastModel = new PMFastScintillatorModel(
+            "PMFastScintillator", G4RegionStore::GetInstance()->GetRegion("ScintillatorRegion"));
+    } else {
+        fFastModel->ResetHitMaker();
+    }
 
     if (!aluminumPhys) {
         G4cerr << "🚨 ERROR: aluminumPhys is NULL! " << G4endl;
         return;
     }
-    G4cout << "🔍 Debug: Checking Aluminum at "
-           << aluminumPhys->GetObjectTranslation() << G4endl;
+    PM_DEBUG("🔍 Debug: Checking Aluminum at "
+             << aluminumPhys->GetObjectTranslation());
 }
@@ -0,0 +1,146 @@
+#include "PMDetectorMessenger.hh"
+#include "PMDetectorConstruction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+PMDetectorMessenger::PMDetectorMessenger(PMDetectorConstruction* detector) : fDetector(detector) {
+    fDirectory = new G4UIdirectory("/PM/det/");
+    fDirectory->SetGuidance("Detector geometry and optical surfaces.");
+
+    fScintSizeCmd = new G4UIcmdWith3VectorAndUnit("/PM/det/scintSize", this);
+    fScintSizeCmd->SetGuidance("Full dimensions of the NaI(Tl) crystal.");
+    fScintSizeCmd->SetParameterName("x", "y", "z", false);
+    fScintSizeCmd->SetRange("x > 0. && y > 0. && z > 0.");
+    fScintSizeCmd->SetDefaultUnit("cm");
+    fScintSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fScintSizeCmd->SetToBeBroadcasted(false);
+
+    fTeflonThicknessCmd = new G4UIcmdWithADoubleAndUnit("/PM/det/teflonThickness", this);
+    fTeflonThicknessCmd->SetGuidance("Thickness of the Teflon wrapping.");
+    fTeflonThicknessCmd->SetParameterName("thickness", false);
+    fTeflonThicknessCmd->SetRange("thickness > 0.");
+    fTeflonThicknessCmd->SetDefaultUnit("mm");
+    fTeflonThicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fTeflonThicknessCmd->SetToBeBroadcasted(false);
+
+    fHoleSizeCmd = new G4UIcmdWithADoubleAndUnit("/PM/det/holeSize", this);
+    fHoleSizeCmd->SetGuidance("Side of the square readout hole and aluminum plate.");
+    fHoleSizeCmd->SetParameterName("size", false);
+    fHoleSizeCmd->SetRange("size > 0.");
+    fHoleSizeCmd->SetDefaultUnit("mm");
+    fHoleSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fHoleSizeCmd->SetToBeBroadcasted(false);
+
+    fReflectivityCmd = new G4UIcmdWithADouble("/PM/det/teflonReflectivity", this);
+    fReflectivityCmd->SetGuidance("Reflectivity of the Teflon surfaces (flat in energy).");
+    fReflectivityCmd->SetGuidance("Applied in place; no geometry rebuild is needed.");
+    fReflectivityCmd->SetParameterName("reflectivity", false);
+    fReflectivityCmd->SetRange("reflectivity >= 0. && reflectivity <= 1.");
+    fReflectivityCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fReflectivityCmd->SetToBeBroadcasted(false);
+
+    fAluminumThicknessCmd = new G4UIcmdWithADoubleAndUnit("/PM/det/aluminumThickness", this);
+    fAluminumThicknessCmd->SetGuidance("Thickness of the aluminum plate in the hole (0: 1.2 x Teflon thickness).");
+    fAluminumThicknessCmd->SetParameterName("thickness", false);
+    fAluminumThicknessCmd->SetRange("thickness >= 0.");
+    fAluminumThicknessCmd->SetDefaultUnit("mm");
+    fAluminumThicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fAluminumThicknessCmd->SetToBeBroadcasted(false);
+
+    fWorldSizeCmd = new G4UIcmdWithADoubleAndUnit("/PM/det/worldSize", this);
+    fWorldSizeCmd->SetGuidance("Minimum side of the world cube; enlarged to fit the module array.");
+    fWorldSizeCmd->SetParameterName("size", false);
+    fWorldSizeCmd->SetRange("size > 0.");
+    fWorldSizeCmd->SetDefaultUnit("cm");
+    fWorldSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fWorldSizeCmd->SetToBeBroadcasted(false);
+
+    fArrayCmd = new G4UIcommand("/PM/det/array", this);
+    fArrayCmd->SetGuidance("Number of detector modules along x and y (copy number iy * nx + ix).");
+    auto* nxParameter = new G4UIparameter("nx", 'i', false);
+    nxParameter->SetParameterRange("nx > 0");
+    fArrayCmd->SetParameter(nxParameter);
+    auto* nyParameter = new G4UIparameter("ny", 'i', false);
+    nyParameter->SetParameterRange("ny > 0");
+    fArrayCmd->SetParameter(nyParameter);
+    fArrayCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fArrayCmd->SetToBeBroadcasted(false);
+
+    fModuleGapCmd = new G4UIcmdWithADoubleAndUnit("/PM/det/moduleGap", this);
+    fModuleGapCmd->SetGuidance("Air gap between neighbouring module envelopes.");
+    fModuleGapCmd->SetParameterName("gap", false);
+    fModuleGapCmd->SetRange("gap >= 0.");
+    fModuleGapCmd->SetDefaultUnit("mm");
+    fModuleGapCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fModuleGapCmd->SetToBeBroadcasted(false);
+}
+
+PMDetectorMessenger::~PMDetectorMessenger() {
+    delete fModuleGapCmd;
+    delete fArrayCmd;
+    delete fWorldSizeCmd;
+    delete fAluminumThicknessCmd;
+    delete fReflectivityCmd;
+    delete fHoleSizeCmd;
+    delete fTeflonThicknessCmd;
+    delete fScintSizeCmd;
+    delete fDirectory;
+}
+
+void PMDetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fScintSizeCmd) {
+        fDetector->SetScintillatorSize(fScintSizeCmd->GetNew3VectorValue(newValue));
+    } else if (command == fTeflonThicknessCmd) {
+        fDetector->SetTeflonThickness(fTeflonThicknessCmd->GetNewDoubleValue(newValue));
+    } else if (command == fHoleSizeCmd) {
+        fDetector->SetHoleSize(fHoleSizeCmd->GetNewDoubleValue(newValue));
+    } else if (command == fReflectivityCmd) {
+        fDetector->SetTeflonReflectivity(fReflectivityCmd->GetNewDoubleValue(newValue));
+    } else if (command == fAluminumThicknessCmd) {
+        fDetector->SetAluminumThickness(fAluminumThicknessCmd->GetNewDoubleValue(newValue));
+    } else if (command == fWorldSizeCmd) {
+        fDetector->SetWorldSize(fWorldSizeCmd->GetNewDoubleValue(newValue));
+    } else if (command == fArrayCmd) {
+        std::istringstream is(newValue);
+        G4int nx, ny;
+        is >> nx >> ny;
+        fDetector->SetArraySize(nx, ny);
+    } else if (command == fModuleGapCmd) {
+        fDetector->SetModuleGap(fModuleGapCmd->GetNewDoubleValue(newValue));
+    }
+}
+
+G4String PMDetectorMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fScintSizeCmd) {
+        return fScintSizeCmd->ConvertToString(fDetector->GetScintillatorSize(), "cm");
+    }
+    if (command == fTeflonThicknessCmd) {
+        return fTeflonThicknessCmd->ConvertToString(fDetector->GetTeflonThickness(), "mm");
+    }
+    if (command == fHoleSizeCmd) {
+        return fHoleSizeCmd->ConvertToString(fDetector->GetHoleSize(), "mm");
+    }
+    if (command == fReflectivityCmd) {
+        return fReflectivityCmd->ConvertToString(fDetector->GetTeflonReflectivity());
+    }
+    if (command == fAluminumThicknessCmd) {
+        return fAluminumThicknessCmd->ConvertToString(fDetector->GetAluminumThickness(), "mm");
+    }
+    if (command == fWorldSizeCmd) {
+        return fWorldSizeCmd->ConvertToString(fDetector->GetWorldSize(), "cm");
+    }
+    if (command == fArrayCmd) {
+        return G4UIcommand::ConvertToString(fDetector->GetArrayNx()) + " "
+             + G4UIcommand::ConvertToString(fDetector->GetArrayNy());
+    }
+    if (command == fModuleGapCmd) {
+        return fModuleGapCmd->ConvertToString(fDetector->GetModuleGap(), "mm");
+    }
+    return "";
+}
@@ -0,0 +1,3 @@
+#include "PMDigi.hh"
+
+G4ThreadLocal G4Allocator<PMDigi>* PMDigiAllocator = nullptr;
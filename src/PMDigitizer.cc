@@ -0,0 +1,178 @@
+#include "PMDigitizer.hh"
+#include "PMDigitizerMessenger.hh"
+#include "PMDigi.hh"
+#include "PMHit.hh"
+#include "PMVolumeRegistry.hh"
+#include "PMAllocCounter.hh"
+#include "G4DigiManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+PMDigitizerConfig* PMDigitizerConfig::Instance() {
+    static PMDigitizerConfig* instance = new PMDigitizerConfig();
+    return instance;
+}
+
+PMDigitizerConfig::PMDigitizerConfig()
+    : fEnabled(false),
+      fQuantumEfficiency(0.25),
+      fSPEResolution(0.3),
+      fDecayTime(0.),
+      fRiseTime(2. * ns),
+      fFallTime(10. * ns),
+      fNoise(0.02),
+      fSamplePeriod(2. * ns),
+      fWindow(4. * us),
+      fCFDFraction(0.2),
+      fMessenger(new PMDigitizerMessenger(this)) {}
+
+namespace {
+// wave[i] += charge * kernel[i]: the only per-sample loop that scales with
+// the event size.
+void AddPulse(float* __restrict wave, const float* __restrict kernel, float charge, G4int n) {
+#pragma omp simd
+    for (G4int i = 0; i < n; ++i) {
+        wave[i] += charge * kernel[i];
+    }
+}
+}
+
+PMDigitizer::PMDigitizer(const G4String& name)
+    : G4VDigitizerModule(name),
+      fPhotonCollectionID(-1),
+      fSamples(0),
+      fSamplePeriod(0.),
+      fRiseTime(0.),
+      fFallTime(0.),
+      fKernelSum(0.) {
+    collectionName.push_back("digis");
+}
+
+// Rebuilds the kernel and resizes the buffers only when the settings or
+// the module count changed since the last event.
+void PMDigitizer::Configure(G4int nModules) {
+    const PMDigitizerConfig* config = PMDigitizerConfig::Instance();
+    const G4int samples = std::max(1, static_cast<G4int>(config->GetWindow() / config->GetSamplePeriod()));
+    if (samples != fSamples || config->GetSamplePeriod() != fSamplePeriod ||
+        config->GetRiseTime() != fRiseTime || config->GetFallTime() != fFallTime) {
+        fSamples = samples;
+        fSamplePeriod = config->GetSamplePeriod();
+        fRiseTime = config->GetRiseTime();
+        fFallTime = config->GetFallTime();
+
+        // Bi-exponential pulse sampled at bin centres, cut at ten fall times.
+        const G4int length = std::min(fSamples, static_cast<G4int>(10. * fFallTime / fSamplePeriod) + 1);
+        fKernel.assign(length, 0.f);
+        G4double peak = 0.;
+        for (G4int i = 0; i < length; ++i) {
+            const G4double t = (i + 0.5) * fSamplePeriod;
+            const G4double value = (fRiseTime > 0. && fRiseTime != fFallTime)
+                                       ? std::exp(-t / fFallTime) - std::exp(-t / fRiseTime)
+                                       : std::exp(-t / fFallTime);
+            fKernel[i] = static_cast<float>(value);
+            peak = std::max(peak, value);
+        }
+        fKernelSum = 0.;
+        for (float& value : fKernel) {
+            value = static_cast<float>(value / peak);
+            fKernelSum += value;
+        }
+        fCharge.clear();
+    }
+    const std::size_t size = static_cast<std::size_t>(nModules) * fSamples;
+    if (fCharge.size() != size) {
+        fCharge.assign(size, 0.f);
+    }
+    fPhotoelectrons.assign(nModules, 0.);
+    fWaveform.resize(fSamples);
+}
+
+void PMDigitizer::Digitize() {
+    PM_ALLOC_SCOPE(kDigitizer);
+    const PMDigitizerConfig* config = PMDigitizerConfig::Instance();
+    G4DigiManager* digiManager = G4DigiManager::GetDMpointer();
+    if (fPhotonCollectionID < 0) {
+        fPhotonCollectionID = digiManager->GetHitsCollectionID("ModuleSD/photons");
+    }
+
+    auto* digis = new PMDigiCollection(GetName(), collectionName[0]);
+    const auto* hits = (fPhotonCollectionID >= 0)
+        ? static_cast<const PMHitsCollection*>(digiManager->GetHitsCollection(fPhotonCollectionID))
+        : nullptr;
+    if (!hits || hits->entries() == 0) {
+        StoreDigiCollection(digis);
+        return;
+    }
+
+    const G4int nModules = PMVolumeRegistry::Instance()->GetModuleCount();
+    Configure(nModules);
+
+    // Photoelectrons, binned by module and sample.
+    const G4double qe = config->GetQuantumEfficiency();
+    const G4double decay = config->GetDecayTime();
+    const G4double speResolution = config->GetSPEResolution();
+    for (const PMHit* hit : *hits->GetVector()) {
+        const G4int module = hit->GetModule();
+        if (module < 0 || module >= nModules || G4UniformRand() >= qe) {
+            continue;
+        }
+        const G4double time = hit->GetTime() + (decay > 0. ? G4RandExponential::shoot(decay) : 0.);
+        const G4int bin = static_cast<G4int>(std::floor(time / fSamplePeriod));
+        if (bin < 0 || bin >= fSamples) {
+            continue;
+        }
+        const G4double gain = std::max(0., G4RandGauss::shoot(1., speResolution));
+        fCharge[static_cast<std::size_t>(module) * fSamples + bin] += static_cast<float>(hit->GetWeight() * gain);
+        fPhotoelectrons[module] += hit->GetWeight();
+    }
+
+    const G4double noise = config->GetNoise();
+    const G4int kernelLength = static_cast<G4int>(fKernel.size());
+    for (G4int module = 0; module < nModules; ++module) {
+        if (fPhotoelectrons[module] <= 0.) {
+            continue;
+        }
+        float* charge = fCharge.data() + static_cast<std::size_t>(module) * fSamples;
+        float* wave = fWaveform.data();
+        std::fill(fWaveform.begin(), fWaveform.end(), 0.f);
+        for (G4int j = 0; j < fSamples; ++j) {
+            if (charge[j] != 0.f) {
+                AddPulse(wave + j, fKernel.data(), charge[j], std::min(kernelLength, fSamples - j));
+                charge[j] = 0.f;
+            }
+        }
+        if (noise > 0.) {
+            for (G4int i = 0; i < fSamples; ++i) {
+                wave[i] += static_cast<float>(G4RandGauss::shoot(0., noise));
+            }
+        }
+
+        G4int peak = 0;
+        G4double sum = 0.;
+        for (G4int i = 0; i < fSamples; ++i) {
+            sum += wave[i];
+            if (wave[i] > wave[peak]) {
+                peak = i;
+            }
+        }
+        const G4double amplitude = wave[peak];
+
+        // Constant-fraction time: last crossing of f * amplitude before the
+        // peak, interpolated between samples.
+        const G4double threshold = config->GetCFDFraction() * amplitude;
+        G4int i = peak;
+        while (i > 0 && wave[i - 1] >= threshold) {
+            --i;
+        }
+        G4double time = (i + 0.5) * fSamplePeriod;
+        if (i > 0 && wave[i] != wave[i - 1]) {
+            time -= fSamplePeriod * (wave[i] - threshold) / (wave[i] - wave[i - 1]);
+        }
+
+        digis->insert(new PMDigi(module, fPhotoelectrons[module], amplitude, sum / fKernelSum, time));
+    }
+    StoreDigiCollection(digis);
+}
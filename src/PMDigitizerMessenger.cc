@@ -0,0 +1,118 @@
+#include "PMDigitizerMessenger.hh"
+#include "PMDigitizer.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+namespace {
+G4UIcmdWithADoubleAndUnit* MakeTimeCommand(const char* path, const char* guidance, const char* range,
+                                           G4UImessenger* messenger) {
+    auto* command = new G4UIcmdWithADoubleAndUnit(path, messenger);
+    command->SetGuidance(guidance);
+    command->SetParameterName("time", false);
+    command->SetRange(range);
+    command->SetDefaultUnit("ns");
+    command->AvailableForStates(G4State_PreInit, G4State_Idle);
+    command->SetToBeBroadcasted(false);
+    return command;
+}
+
+G4UIcmdWithADouble* MakeValueCommand(const char* path, const char* guidance, const char* range,
+                                     G4UImessenger* messenger) {
+    auto* command = new G4UIcmdWithADouble(path, messenger);
+    command->SetGuidance(guidance);
+    command->SetParameterName("value", false);
+    command->SetRange(range);
+    command->AvailableForStates(G4State_PreInit, G4State_Idle);
+    command->SetToBeBroadcasted(false);
+    return command;
+}
+}
+
+PMDigitizerMessenger::PMDigitizerMessenger(PMDigitizerConfig* config) : fConfig(config) {
+    fDirectory = new G4UIdirectory("/PM/digi/");
+    fDirectory->SetGuidance("Photon-to-waveform digitization of the aluminum window readout.");
+
+    fEnableCmd = new G4UIcmdWithABool("/PM/digi/enable", this);
+    fEnableCmd->SetGuidance("Digitize every event (pulse amplitude, integral and time per module).");
+    fEnableCmd->SetParameterName("enabled", true);
+    fEnableCmd->SetDefaultValue(true);
+    fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEnableCmd->SetToBeBroadcasted(false);
+
+    fQECmd = MakeValueCommand("/PM/digi/quantumEfficiency",
+                              "Probability that a detected photon yields a photoelectron.",
+                              "value >= 0. && value <= 1.", this);
+    fSPECmd = MakeValueCommand("/PM/digi/speResolution",
+                               "Relative Gaussian width of the single-photoelectron charge.",
+                               "value >= 0.", this);
+    fDecayCmd = MakeTimeCommand("/PM/digi/decayTime",
+                                "Extra exponential delay added per photoelectron. Default 0: photon "
+                                "hits already carry the crystal's SCINTILLATIONTIMECONSTANT1.",
+                                "time >= 0.", this);
+    fRiseCmd = MakeTimeCommand("/PM/digi/riseTime", "Rise time of the single-photoelectron pulse.",
+                               "time >= 0.", this);
+    fFallCmd = MakeTimeCommand("/PM/digi/fallTime", "Fall time of the single-photoelectron pulse.",
+                               "time > 0.", this);
+    fNoiseCmd = MakeValueCommand("/PM/digi/noise",
+                                 "Gaussian noise per sample, in single-photoelectron amplitudes.",
+                                 "value >= 0.", this);
+    fSampleCmd = MakeTimeCommand("/PM/digi/samplePeriod", "Digitizer sampling period.", "time > 0.", this);
+    fWindowCmd = MakeTimeCommand("/PM/digi/window", "Length of the recorded waveform from t = 0.",
+                                 "time > 0.", this);
+    fCFDCmd = MakeValueCommand("/PM/digi/cfdFraction", "Constant fraction of the amplitude used for timing.",
+                               "value > 0. && value < 1.", this);
+}
+
+PMDigitizerMessenger::~PMDigitizerMessenger() {
+    delete fCFDCmd;
+    delete fWindowCmd;
+    delete fSampleCmd;
+    delete fNoiseCmd;
+    delete fFallCmd;
+    delete fRiseCmd;
+    delete fDecayCmd;
+    delete fSPECmd;
+    delete fQECmd;
+    delete fEnableCmd;
+    delete fDirectory;
+}
+
+void PMDigitizerMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fEnableCmd) {
+        fConfig->SetEnabled(G4UIcmdWithABool::GetNewBoolValue(newValue));
+    } else if (command == fQECmd) {
+        fConfig->SetQuantumEfficiency(G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+    } else if (command == fSPECmd) {
+        fConfig->SetSPEResolution(G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+    } else if (command == fDecayCmd) {
+        fConfig->SetDecayTime(G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+    } else if (command == fRiseCmd) {
+        fConfig->SetRiseTime(G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+    } else if (command == fFallCmd) {
+        fConfig->SetFallTime(G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+    } else if (command == fNoiseCmd) {
+        fConfig->SetNoise(G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+    } else if (command == fSampleCmd) {
+        fConfig->SetSamplePeriod(G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+    } else if (command == fWindowCmd) {
+        fConfig->SetWindow(G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+    } else if (command == fCFDCmd) {
+        fConfig->SetCFDFraction(G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+    }
+}
+
+G4String PMDigitizerMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fEnableCmd) return G4UIcommand::ConvertToString(fConfig->IsEnabled());
+    if (command == fQECmd) return G4UIcommand::ConvertToString(fConfig->GetQuantumEfficiency());
+    if (command == fSPECmd) return G4UIcommand::ConvertToString(fConfig->GetSPEResolution());
+    if (command == fDecayCmd) return fDecayCmd->ConvertToString(fConfig->GetDecayTime(), "ns");
+    if (command == fRiseCmd) return fRiseCmd->ConvertToString(fConfig->GetRiseTime(), "ns");
+    if (command == fFallCmd) return fFallCmd->ConvertToString(fConfig->GetFallTime(), "ns");
+    if (command == fNoiseCmd) return G4UIcommand::ConvertToString(fConfig->GetNoise());
+    if (command == fSampleCmd) return fSampleCmd->ConvertToString(fConfig->GetSamplePeriod(), "ns");
+    if (command == fWindowCmd) return fWindowCmd->ConvertToString(fConfig->GetWindow(), "ns");
+    if (command == fCFDCmd) return G4UIcommand::ConvertToString(fConfig->GetCFDFraction());
+    return "";
+}
@@ -0,0 +1,64 @@
+#include "PMEmissionSpectrum.hh"
+#include "G4Exception.hh"
+
+#include <cmath>
+#include <map>
+#include <memory>
+
+namespace {
+std::map<const G4Material*, std::unique_ptr<PMEmissionSpectrum>> spectra;
+}
+
+PMEmissionSpectrum::PMEmissionSpectrum(const std::vector<G4double>& energies,
+                                       const std::vector<G4double>& intensities)
+    : fInverseCDF(kTableSize + 1, 0.), fMeanEnergy(0.) {
+    const std::size_t n = energies.size();
+    std::vector<G4double> cdf(n, 0.);
+    G4double moment = 0.;
+    for (std::size_t j = 1; j < n; ++j) {
+        const G4double h = energies[j] - energies[j - 1];
+        cdf[j] = cdf[j - 1] + 0.5 * (intensities[j - 1] + intensities[j]) * h;
+        moment += h * (intensities[j - 1] * (2. * energies[j - 1] + energies[j])
+                       + intensities[j] * (energies[j - 1] + 2. * energies[j])) / 6.;
+    }
+    const G4double total = n > 1 ? cdf.back() : 0.;
+    if (!(total > 0.)) {
+        G4Exception("PMEmissionSpectrum::PMEmissionSpectrum", "PMMaterial004", FatalException,
+                    "Emission spectrum has no intensity");
+        return;
+    }
+    fMeanEnergy = moment / total;
+
+    // Invert the piecewise-quadratic CDF exactly at u = k / kTableSize:
+    // within a segment, p0 t + (p1 - p0) t^2 / 2h = m.
+    std::size_t j = 1;
+    for (G4int k = 0; k <= kTableSize; ++k) {
+        const G4double target = total * k / kTableSize;
+        while (j < n - 1 && cdf[j] < target) ++j;
+        const G4double h = energies[j] - energies[j - 1];
+        const G4double p0 = intensities[j - 1];
+        const G4double a = 0.5 * (intensities[j] - p0) / h;
+        const G4double m = std::max(0., target - cdf[j - 1]);
+        const G4double root = std::sqrt(std::max(0., p0 * p0 + 4. * a * m));
+        const G4double t = (p0 + root > 0.) ? 2. * m / (p0 + root) : 0.;
+        fInverseCDF[k] = energies[j - 1] + std::min(t, h);
+    }
+}
+
+const PMEmissionSpectrum* PMEmissionSpectrum::Build(const G4Material* material,
+                                                    const std::vector<G4double>& energies,
+                                                    const std::vector<G4double>& intensities) {
+    // Rebuilt in place, so pointers cached by the workers stay valid.
+    std::unique_ptr<PMEmissionSpectrum>& entry = spectra[material];
+    if (entry) {
+        *entry = PMEmissionSpectrum(energies, intensities);
+    } else {
+        entry.reset(new PMEmissionSpectrum(energies, intensities));
+    }
+    return entry.get();
+}
+
+const PMEmissionSpectrum* PMEmissionSpectrum::Find(const G4Material* material) {
+    auto it = spectra.find(material);
+    return it != spectra.end() ? it->second.get() : nullptr;
+}
@@ -1,82 +1,224 @@
 #include "PMEventAction.hh"
+#include "PMRunAction.hh"
+#include "PMOutputManager.hh"
+#include "PMColumnarWriter.hh"
+#include "PMPhotonRecordBuffer.hh"
+#include "PMHistogramSet.hh"
+#include "PMHit.hh"
+#include "PMDigi.hh"
+#include "PMDigitizer.hh"
+#include "PMShard.hh"
+#include "PMAllocCounter.hh"
+#include "PMMetrics.hh"
 #include "G4Event.hh"
 #include "G4EventManager.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
+#include "G4DigiManager.hh"
 #include "G4AnalysisManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "PMLog.hh"
 
-PMEventAction::PMEventAction()
+PMEventAction::PMEventAction(PMRunAction* runAction)
     : G4UserEventAction(),
+      fRunAction(runAction),
+      fHistograms(runAction ? runAction->GetHistograms() : nullptr),
+      fPhotonRecords(nullptr),
       fOpticalPhotonCount(0),
       fGammaTeflonCount(0),
       fAluminumPhotonCount(0), 
+      fPhotonsAtAluminumBoundary(0),
+      fAluminumWeight(0.),
       fScintillationCount(0),
-      fTotalEnergyDep(0.) {
+      fTotalEnergyDep(0.),
+      fStepCount(0),
+      fEdepCollectionID(-1),
+      fPhotonCollectionID(-1),
+      fDigiCollectionID(-1),
+      fDigiCharge(0.),
+      fDigiTime(-1.) {
 }
 
 PMEventAction::~PMEventAction() {}
 
 void PMEventAction::BeginOfEventAction(const G4Event*) {
+    PM_ALLOC_SCOPE(kEvent);
     fOpticalPhotonCount = 0;
     fGammaTeflonCount = 0;
     fAluminumPhotonCount = 0;
+    fPhotonsAtAluminumBoundary = 0;
+    fAluminumWeight = 0.;
     fScintillationCount = 0;
     fTotalEnergyDep = 0.;
-    fEnergyDeposits.clear();
+    fStepCount = 0;
+    fDigiCharge = 0.;
+    fDigiTime = -1.;
+
+    fPhotonRecords = (fRunAction && PMOutputManager::Instance()->IsPhotonRecordingEnabled())
+                         ? fRunAction->GetPhotonRecords() : nullptr;
+    if (fPhotonRecords) {
+        fPhotonRecords->Clear();
+    }
+}
+
+// The only place tracked-photon detections and crystal energy are summed:
+// one pass over the contiguous hit vectors per event.
+void PMEventAction::ReadHits(const G4Event* event) {
+    G4HCofThisEvent* hce = event->GetHCofThisEvent();
+    if (!hce) {
+        return;
+    }
+    if (fEdepCollectionID < 0) {
+        G4SDManager* sdManager = G4SDManager::GetSDMpointer();
+        fEdepCollectionID = sdManager->GetCollectionID("ModuleSD/edep");
+        fPhotonCollectionID = sdManager->GetCollectionID("ModuleSD/photons");
+    }
+
+    if (const auto* edepHits = static_cast<const PMHitsCollection*>(hce->GetHC(fEdepCollectionID))) {
+        for (const PMHit* hit : *edepHits->GetVector()) {
+            fTotalEnergyDep += hit->GetEnergy();
+        }
+    }
+    if (const auto* photonHits = static_cast<const PMHitsCollection*>(hce->GetHC(fPhotonCollectionID))) {
+        const std::vector<PMHit*>& hits = *photonHits->GetVector();
+        G4double weight = 0.;
+        for (const PMHit* hit : hits) {
+            weight += hit->GetWeight();
+        }
+        fAluminumPhotonCount += static_cast<G4int>(hits.size());
+        fAluminumWeight += weight;
+    }
+}
+
+void PMEventAction::ReadDigis() {
+    G4DigiManager* digiManager = G4DigiManager::GetDMpointer();
+    digiManager->Digitize("PMDigitizer");
+    if (fDigiCollectionID < 0) {
+        fDigiCollectionID = digiManager->GetDigiCollectionID("PMDigitizer/digis");
+    }
+    const auto* digis = static_cast<const PMDigiCollection*>(digiManager->GetDigiCollection(fDigiCollectionID));
+    if (!digis) {
+        return;
+    }
+    for (const PMDigi* digi : *digis->GetVector()) {
+        fDigiCharge += digi->GetIntegral();
+        if (fDigiTime < 0. || digi->GetTime() < fDigiTime) {
+            fDigiTime = digi->GetTime();
+        }
+    }
 }
 
 void PMEventAction::EndOfEventAction(const G4Event* event) {
-    G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
-
-    analysisManager->FillH1(0, fOpticalPhotonCount);
-    analysisManager->FillH1(1, fGammaTeflonCount);
-    analysisManager->FillH1(2, fAluminumPhotonCount); 
-    analysisManager->FillH1(3, fScintillationCount);
-    analysisManager->FillH1(4, fTotalEnergyDep / MeV);
-
-    analysisManager->FillNtupleIColumn(0, event->GetEventID());
-    analysisManager->FillNtupleIColumn(1, fOpticalPhotonCount);
-    analysisManager->FillNtupleIColumn(2, fGammaTeflonCount);
-    analysisManager->FillNtupleIColumn(3, fAluminumPhotonCount);
-    analysisManager->FillNtupleIColumn(4, fScintillationCount);
-    analysisManager->FillNtupleDColumn(5, fTotalEnergyDep / MeV);
-    analysisManager->AddNtupleRow();
-
-    G4cout << "\n====== Event " << event->GetEventID() << " Summary ======\n"
-           << "💡 Total Optical Photons: " << fOpticalPhotonCount << "\n"
-           << "🔹 Optical Photons Detected at Aluminum: " << fAluminumPhotonCount << "\n"
-           << "🔎 Energy Deposited in NaI: " << fTotalEnergyDep << " MeV\n"
-           << "🔹 Gammas at Teflon Barrier: " << fGammaTeflonCount << "\n"
-           << "==========================================\n" << G4endl;
+    PM_ALLOC_SCOPE(kEvent);
+    // Fits: PMShard::BeginOfRun rejects runs whose global IDs would not.
+    const G4int eventID = static_cast<G4int>(PMShard::Instance()->GetGlobalEventID(event->GetEventID()));
+    ReadHits(event);
+    if (PMDigitizerConfig::Instance()->IsEnabled()) {
+        ReadDigis();
+    }
+
+    if (fHistograms) {
+        fHistograms->Fill(PMHistID::kEdep, fTotalEnergyDep / MeV);
+        fHistograms->Fill(PMHistID::kEdepFine, fTotalEnergyDep / MeV);
+        fHistograms->Fill(PMHistID::kOptical, fOpticalPhotonCount);
+        fHistograms->Fill(PMHistID::kScintillation, fScintillationCount);
+        fHistograms->Fill(PMHistID::kAluminum, fAluminumWeight);
+        fHistograms->Fill(PMHistID::kGammaTeflon, fGammaTeflonCount);
+    }
+
+    if (PMOutputManager::Instance()->IsRootEnabled()) {
+        G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+        analysisManager->FillNtupleIColumn(0, PMRunAction::kEventID, eventID);
+        analysisManager->FillNtupleIColumn(0, PMRunAction::kOptical, fOpticalPhotonCount);
+        analysisManager->FillNtupleIColumn(0, PMRunAction::kGammaTeflon, fGammaTeflonCount);
+        analysisManager->FillNtupleIColumn(0, PMRunAction::kAluminum, fAluminumPhotonCount);
+        analysisManager->FillNtupleIColumn(0, PMRunAction::kScintillation, fScintillationCount);
+        analysisManager->FillNtupleDColumn(0, PMRunAction::kEdep, fTotalEnergyDep / MeV);
+        analysisManager->FillNtupleDColumn(0, PMRunAction::kAluminumWeight, fAluminumWeight);
+        analysisManager->FillNtupleDColumn(0, PMRunAction::kDigiCharge, fDigiCharge);
+        analysisManager->FillNtupleDColumn(0, PMRunAction::kDigiTime, fDigiTime / ns);
+        analysisManager->AddNtupleRow(0);
+
+        // One row per event; the photon columns are the bound SoA vectors.
+        if (fPhotonRecords) {
+            analysisManager->FillNtupleIColumn(1, 0, eventID);
+            analysisManager->AddNtupleRow(1);
+        }
+    }
+
+    PMColumnarWriter* writer = fRunAction ? fRunAction->GetEventWriter() : nullptr;
+    if (writer && writer->IsOpen()) {
+        writer->Fill(PMRunAction::kEventID, eventID);
+        writer->Fill(PMRunAction::kOptical, fOpticalPhotonCount);
+        writer->Fill(PMRunAction::kGammaTeflon, fGammaTeflonCount);
+        writer->Fill(PMRunAction::kAluminum, fAluminumPhotonCount);
+        writer->Fill(PMRunAction::kScintillation, fScintillationCount);
+        writer->Fill(PMRunAction::kEdep, fTotalEnergyDep / MeV);
+        writer->Fill(PMRunAction::kAluminumWeight, fAluminumWeight);
+        writer->Fill(PMRunAction::kDigiCharge, fDigiCharge);
+        writer->Fill(PMRunAction::kDigiTime, fDigiTime / ns);
+        writer->AddRow();
+    }
+
+    PMColumnarWriter* photonWriter = fRunAction ? fRunAction->GetPhotonWriter() : nullptr;
+    if (fPhotonRecords && photonWriter && photonWriter->IsOpen()) {
+        const PMPhotonRecordBuffer& records = *fPhotonRecords;
+        for (std::size_t i = 0; i < records.Size(); ++i) {
+            photonWriter->Fill(0, eventID);
+            photonWriter->Fill(1, records.fX[i]);
+            photonWriter->Fill(2, records.fY[i]);
+            photonWriter->Fill(3, records.fZ[i]);
+            photonWriter->Fill(4, records.fTime[i]);
+            photonWriter->Fill(5, records.fWavelength[i]);
+            photonWriter->Fill(6, records.fBounces[i]);
+            photonWriter->Fill(7, records.fCreationX[i]);
+            photonWriter->Fill(8, records.fCreationY[i]);
+            photonWriter->Fill(9, records.fCreationZ[i]);
+            photonWriter->Fill(10, records.fWeight[i]);
+            photonWriter->AddRow();
+        }
+    }
+
+    if (fRunAction) {
+        fRunAction->AddEvent(fOpticalPhotonCount, fAluminumPhotonCount,
+                             fScintillationCount, fGammaTeflonCount, fTotalEnergyDep,
+                             fStepCount, fAluminumWeight);
+    }
+    PMMetrics::AddEvent(fOpticalPhotonCount, fTotalEnergyDep, fStepCount);
+
+    PM_DEBUG("\n====== Event " << event->GetEventID() << " Summary ======\n"
+             << "💡 Total Optical Photons: " << fOpticalPhotonCount << "\n"
+             << "🔹 Optical Photons Detected at Aluminum: " << fAluminumPhotonCount << "\n"
+             << "🔎 Energy Deposited in NaI: " << fTotalEnergyDep / MeV << " MeV\n"
+             << "🔹 Gammas at Teflon Barrier: " << fGammaTeflonCount << "\n"
+             << "==========================================\n");
 
     if (fOpticalPhotonCount == 0) {
-        G4cout << "⚠️ WARNING: Event " << event->GetEventID()
-               << " produced **NO** optical photons!" << G4endl;
+        PM_DEBUG("⚠️ WARNING: Event " << event->GetEventID()
+                 << " produced **NO** optical photons!");
     }
+
+    PMAllocCounter::EndOfEvent();
 }
 
 void PMEventAction::AddOpticalPhoton() {
     fOpticalPhotonCount++;
-    const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
-    
-    G4cout << "💡 Optical Photon Created in Event " << event->GetEventID()
-           << " | Count: " << fOpticalPhotonCount << G4endl;
+    PM_TRACE("💡 Optical Photon Created in Event "
+             << G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID()
+             << " | Count: " << fOpticalPhotonCount);
 }
 
 void PMEventAction::AddGammaToTeflon() {
     fGammaTeflonCount++;
 }
 
-void PMEventAction::AddAluminumPhoton() {  
+void PMEventAction::AddAluminumPhoton(G4double weight) {
     fAluminumPhotonCount++;
+    fAluminumWeight += weight;
     fPhotonsAtAluminumBoundary++;
-    G4cout << " Optical Photon Detected at Aluminum! Count: " << fAluminumPhotonCount << G4endl;
+    PM_TRACE(" Optical Photon Detected at Aluminum! Count: " << fAluminumPhotonCount);
 }
 
 void PMEventAction::AddScintillationPhoton() {
     fScintillationCount++;
 }
-
-void PMEventAction::RecordEnergy(G4double energy) {
-    fTotalEnergyDep += energy;
-    fEnergyDeposits.push_back(energy);
-}
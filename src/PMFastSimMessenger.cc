@@ -0,0 +1,64 @@
+#include "PMFastSimMessenger.hh"
+#include "PMFastScintillatorModel.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+PMFastSimMessenger::PMFastSimMessenger(PMFastSimConfig* config) : fConfig(config) {
+    fDirectory = new G4UIdirectory("/PM/fastsim/");
+    fDirectory->SetGuidance("Parametrized NaI response (electrons and optical photons not tracked).");
+
+    fEnableCmd = new G4UIcmdWithABool("/PM/fastsim/enable", this);
+    fEnableCmd->SetGuidance("Use the parametrized crystal response from the next run on.");
+    fEnableCmd->SetParameterName("enabled", true);
+    fEnableCmd->SetDefaultValue(true);
+    fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEnableCmd->SetToBeBroadcasted(false);
+
+    fMaxEnergyCmd = new G4UIcmdWithADoubleAndUnit("/PM/fastsim/maxEnergy", this);
+    fMaxEnergyCmd->SetGuidance("Electrons above this kinetic energy keep full tracking.");
+    fMaxEnergyCmd->SetParameterName("energy", false);
+    fMaxEnergyCmd->SetRange("energy > 0.");
+    fMaxEnergyCmd->SetDefaultUnit("MeV");
+    fMaxEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fMaxEnergyCmd->SetToBeBroadcasted(false);
+
+    fLightCollectionCmd = new G4UIcmdWithADouble("/PM/fastsim/lightCollection", this);
+    fLightCollectionCmd->SetGuidance("Flat photon detection probability, used unless /PM/optical/mode fast");
+    fLightCollectionCmd->SetGuidance("has loaded a light-collection map.");
+    fLightCollectionCmd->SetParameterName("efficiency", false);
+    fLightCollectionCmd->SetRange("efficiency >= 0. && efficiency <= 1.");
+    fLightCollectionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fLightCollectionCmd->SetToBeBroadcasted(false);
+}
+
+PMFastSimMessenger::~PMFastSimMessenger() {
+    delete fLightCollectionCmd;
+    delete fMaxEnergyCmd;
+    delete fEnableCmd;
+    delete fDirectory;
+}
+
+void PMFastSimMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fEnableCmd) {
+        fConfig->SetEnabled(G4UIcmdWithABool::GetNewBoolValue(newValue));
+    } else if (command == fMaxEnergyCmd) {
+        fConfig->SetMaxEnergy(G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+    } else if (command == fLightCollectionCmd) {
+        fConfig->SetLightCollection(G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+    }
+}
+
+G4String PMFastSimMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fEnableCmd) {
+        return G4UIcommand::ConvertToString(fConfig->IsEnabled());
+    }
+    if (command == fMaxEnergyCmd) {
+        return fMaxEnergyCmd->ConvertToString(fConfig->GetMaxEnergy(), "MeV");
+    }
+    if (command == fLightCollectionCmd) {
+        return G4UIcommand::ConvertToString(fConfig->GetLightCollection());
+    }
+    return "";
+}
@@ -0,0 +1,98 @@
+#include "PMHistogramSet.hh"
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr std::size_t kAlignment = 64;
+constexpr std::size_t kSlotsPerLine = kAlignment / sizeof(G4double);
+
+// Indexed by PMHistID.
+const PMHistogramDef kHistogramDefs[] = {
+    {"Edep",          "Energy deposit in NaI [MeV]",            200,   0., 10.},
+    {"EdepFine",      "Energy deposit in NaI [MeV], fine",      16384, 0., 10.},
+    {"Optical",       "Optical photons per event",              1000,  0., 1.e6},
+    {"Scintillation", "Scintillation photons per event",        1000,  0., 1.e6},
+    {"Aluminum",      "Photons at the aluminum window per event", 1000, 0., 1.e6},
+    {"GammaTeflon",   "Gammas entering the Teflon per event",   100,   0., 100.},
+};
+static_assert(sizeof(kHistogramDefs) / sizeof(kHistogramDefs[0])
+                  == static_cast<std::size_t>(PMHistID::kCount),
+              "booking table does not match PMHistID");
+
+G4Mutex threadSetMutex = G4MUTEX_INITIALIZER;
+std::vector<std::pair<G4int, const PMHistogramSet*>> threadSets;
+}
+
+const PMHistogramDef& PMHistogramSet::GetDef(PMHistID id) {
+    return kHistogramDefs[static_cast<G4int>(id)];
+}
+
+PMHistogramSet::PMHistogramSet() : fData(nullptr), fSize(0) {
+    for (G4int h = 0; h < kNumHistograms; ++h) {
+        const PMHistogramDef& def = kHistogramDefs[h];
+        std::size_t slots = def.nBins + 2;
+        fOffset[h] = fSize;
+        fSize += (slots + kSlotsPerLine - 1) / kSlotsPerLine * kSlotsPerLine;
+        fNBins[h] = def.nBins;
+        fMin[h] = def.min;
+        fInvWidth[h] = def.nBins / (def.max - def.min);
+    }
+    fData = static_cast<G4double*>(
+        ::operator new[](fSize * sizeof(G4double), std::align_val_t(kAlignment)));
+    Reset();
+}
+
+PMHistogramSet::~PMHistogramSet() {
+    ::operator delete[](fData, std::align_val_t(kAlignment));
+}
+
+void PMHistogramSet::Reset() {
+    std::fill(fData, fData + fSize, 0.);
+}
+
+void PMHistogramSet::Add(const PMHistogramSet& other) {
+    for (std::size_t i = 0; i < fSize; ++i) {
+        fData[i] += other.fData[i];
+    }
+}
+
+G4bool PMHistogramSet::Write(const G4String& fileName) const {
+    std::FILE* file = std::fopen(fileName.c_str(), "w");
+    if (!file) return false;
+
+    std::fprintf(file, "# PMHistogramSet 1\n");
+    for (G4int h = 0; h < kNumHistograms; ++h) {
+        const PMHistogramDef& def = kHistogramDefs[h];
+        std::fprintf(file, "histogram %s %d %.17g %.17g\n", def.name, def.nBins, def.min, def.max);
+        const G4double* slots = fData + fOffset[h];
+        for (G4int i = 0; i < def.nBins + 2; ++i) {
+            std::fprintf(file, "%.17g\n", slots[i]);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+void PMHistogramSet::ClearThreadSets() {
+    G4AutoLock lock(&threadSetMutex);
+    threadSets.clear();
+}
+
+void PMHistogramSet::RegisterThreadSet(G4int threadId, const PMHistogramSet* set) {
+    G4AutoLock lock(&threadSetMutex);
+    threadSets.emplace_back(threadId, set);
+}
+
+void PMHistogramSet::MergeThreadSets() {
+    G4AutoLock lock(&threadSetMutex);
+    std::sort(threadSets.begin(), threadSets.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    Reset();
+    for (const auto& entry : threadSets) {
+        Add(*entry.second);
+    }
+}
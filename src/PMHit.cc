@@ -0,0 +1,3 @@
+#include "PMHit.hh"
+
+G4ThreadLocal G4Allocator<PMHit>* PMHitAllocator = nullptr;
@@ -0,0 +1,142 @@
+#include "PMLightCollectionMap.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace {
+const char kMagic[8] = {'P', 'M', 'L', 'C', 'E', 'M', 'A', '1'};
+}
+
+PMLightCollectionMap::PMLightCollectionMap()
+    : fNx(0), fNy(0), fNz(0), fNWavelength(0),
+      fMinWavelength(0.), fMaxWavelength(0.), fMeanEfficiency(0.) {}
+
+void PMLightCollectionMap::Configure(const G4ThreeVector& halfSize, G4int nx, G4int ny, G4int nz,
+                                     G4int nWavelength, G4double minWavelength, G4double maxWavelength) {
+    fHalfSize = halfSize;
+    fNx = nx;
+    fNy = ny;
+    fNz = nz;
+    fNWavelength = nWavelength;
+    fMinWavelength = minWavelength;
+    fMaxWavelength = maxWavelength;
+    Reset();
+}
+
+void PMLightCollectionMap::Reset() {
+    std::size_t cells = static_cast<std::size_t>(fNx) * fNy * fNz * fNWavelength;
+    fEmitted.assign(cells, 0.);
+    fDetected.assign(cells, 0.);
+    fEfficiency.assign(cells, 0.f);
+    fMeanEfficiency = 0.;
+}
+
+G4int PMLightCollectionMap::Index(const G4ThreeVector& position, G4double photonEnergy) const {
+    if (photonEnergy <= 0.) {
+        return -1;
+    }
+    G4double wavelength = h_Planck * c_light / photonEnergy;
+
+    G4int ix = static_cast<G4int>((position.x() + fHalfSize.x()) / (2. * fHalfSize.x()) * fNx);
+    G4int iy = static_cast<G4int>((position.y() + fHalfSize.y()) / (2. * fHalfSize.y()) * fNy);
+    G4int iz = static_cast<G4int>((position.z() + fHalfSize.z()) / (2. * fHalfSize.z()) * fNz);
+    G4int iw = static_cast<G4int>((wavelength - fMinWavelength) / (fMaxWavelength - fMinWavelength) * fNWavelength);
+
+    if (ix < 0 || ix >= fNx || iy < 0 || iy >= fNy || iz < 0 || iz >= fNz ||
+        iw < 0 || iw >= fNWavelength) {
+        return -1;
+    }
+    return ((iw * fNz + iz) * fNy + iy) * fNx + ix;
+}
+
+void PMLightCollectionMap::Add(const PMLightCollectionMap& other) {
+    for (std::size_t i = 0; i < fEmitted.size(); ++i) {
+        fEmitted[i] += other.fEmitted[i];
+        fDetected[i] += other.fDetected[i];
+    }
+}
+
+void PMLightCollectionMap::UpdateEfficiency() {
+    G4double emitted = GetTotalEmitted();
+    fMeanEfficiency = (emitted > 0.) ? GetTotalDetected() / emitted : 0.;
+
+    // Cells never reached during calibration fall back to the mean.
+    for (std::size_t i = 0; i < fEmitted.size(); ++i) {
+        fEfficiency[i] = static_cast<G4float>(
+            (fEmitted[i] > 0.) ? fDetected[i] / fEmitted[i] : fMeanEfficiency);
+    }
+}
+
+G4double PMLightCollectionMap::GetTotalEmitted() const {
+    G4double total = 0.;
+    for (G4double n : fEmitted) total += n;
+    return total;
+}
+
+G4double PMLightCollectionMap::GetTotalDetected() const {
+    G4double total = 0.;
+    for (G4double n : fDetected) total += n;
+    return total;
+}
+
+G4bool PMLightCollectionMap::Save(const G4String& fileName) const {
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    G4int dims[4] = {fNx, fNy, fNz, fNWavelength};
+    G4double ranges[5] = {fHalfSize.x() / mm, fHalfSize.y() / mm, fHalfSize.z() / mm,
+                          fMinWavelength / nm, fMaxWavelength / nm};
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    out.write(reinterpret_cast<const char*>(ranges), sizeof(ranges));
+    out.write(reinterpret_cast<const char*>(fEmitted.data()), fEmitted.size() * sizeof(G4double));
+    out.write(reinterpret_cast<const char*>(fDetected.data()), fDetected.size() * sizeof(G4double));
+    return static_cast<G4bool>(out);
+}
+
+G4bool PMLightCollectionMap::Load(const G4String& fileName) {
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    char magic[sizeof(kMagic)];
+    G4int dims[4];
+    G4double ranges[5];
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(dims), sizeof(dims));
+    in.read(reinterpret_cast<char*>(ranges), sizeof(ranges));
+    if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    std::uint64_t cells = 1;
+    for (G4int n : dims) {
+        if (n <= 0 || n > 4096) {
+            return false;
+        }
+        cells *= static_cast<std::uint64_t>(n);
+    }
+    // The two count arrays must fill the rest of the file exactly; checked
+    // before Configure() allocates them, so a corrupt header cannot ask
+    // for terabytes.
+    const std::streamoff header = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streamoff remaining = in.tellg() - header;
+    if (!in || remaining < 0 || cells * 2 * sizeof(G4double) != static_cast<std::uint64_t>(remaining)) {
+        return false;
+    }
+    in.seekg(header);
+
+    Configure(G4ThreeVector(ranges[0] * mm, ranges[1] * mm, ranges[2] * mm),
+              dims[0], dims[1], dims[2], dims[3], ranges[3] * nm, ranges[4] * nm);
+    in.read(reinterpret_cast<char*>(fEmitted.data()), fEmitted.size() * sizeof(G4double));
+    in.read(reinterpret_cast<char*>(fDetected.data()), fDetected.size() * sizeof(G4double));
+    if (!in) {
+        return false;
+    }
+    UpdateEfficiency();
+    return true;
+}
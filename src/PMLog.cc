@@ -0,0 +1,44 @@
+#include "PMLog.hh"
+#include "PMLogMessenger.hh"
+
+std::atomic<G4int> PMLog::fLevel(PM_LOG_DEFAULT_LEVEL);
+
+PMLog::PMLog() : fMessenger(new PMLogMessenger()) {}
+
+PMLog::~PMLog() {
+    delete fMessenger;
+}
+
+PMLog* PMLog::Instance() {
+    // Never destroyed: the messenger's commands must not outlive G4UImanager.
+    static PMLog* instance = new PMLog();
+    return instance;
+}
+
+void PMLog::SetLevel(G4int level) {
+    if (level > PM_LOG_MAX_LEVEL) {
+        G4cout << "⚠️ WARNING: log level " << LevelName(level)
+               << " was compiled out (PM_LOG_MAX_LEVEL=" << PM_LOG_MAX_LEVEL
+               << "); using " << LevelName(PM_LOG_MAX_LEVEL) << G4endl;
+        level = PM_LOG_MAX_LEVEL;
+    }
+    fLevel.store(level, std::memory_order_relaxed);
+}
+
+G4int PMLog::ParseLevel(const G4String& name) {
+    if (name == "off")     return kOff;
+    if (name == "summary") return kSummary;
+    if (name == "debug")   return kDebug;
+    if (name == "trace")   return kTrace;
+    return -1;
+}
+
+const char* PMLog::LevelName(G4int level) {
+    switch (level) {
+        case kOff:     return "off";
+        case kSummary: return "summary";
+        case kDebug:   return "debug";
+        case kTrace:   return "trace";
+        default:       return "unknown";
+    }
+}
@@ -0,0 +1,35 @@
+#include "PMLogMessenger.hh"
+#include "PMLog.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+
+PMLogMessenger::PMLogMessenger() {
+    fDirectory = new G4UIdirectory("/PM/log/");
+    fDirectory->SetGuidance("Console output verbosity.");
+
+    fLevelCmd = new G4UIcmdWithAString("/PM/log/level", this);
+    fLevelCmd->SetGuidance("Set the log level shared by all threads.");
+    fLevelCmd->SetGuidance("Levels above the build's PM_LOG_MAX_LEVEL are compiled out.");
+    fLevelCmd->SetParameterName("level", false);
+    fLevelCmd->SetCandidates("off summary debug trace");
+    fLevelCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fLevelCmd->SetToBeBroadcasted(false);
+}
+
+PMLogMessenger::~PMLogMessenger() {
+    delete fLevelCmd;
+    delete fDirectory;
+}
+
+void PMLogMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fLevelCmd) {
+        PMLog::SetLevel(PMLog::ParseLevel(newValue));
+    }
+}
+
+G4String PMLogMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fLevelCmd) {
+        return PMLog::LevelName(PMLog::GetLevel());
+    }
+    return "";
+}
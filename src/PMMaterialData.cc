@@ -0,0 +1,142 @@
+#include "PMMaterialData.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4UnitsTable.hh"
+#include "G4Exception.hh"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+[[noreturn]] void Invalid(const G4String& fileName, G4int line, const G4String& what) {
+    G4ExceptionDescription msg;
+    msg << fileName << ":" << line << ": " << what;
+    G4Exception("PMMaterialData::Load", "PMMaterial002", FatalException, msg);
+    std::abort();
+}
+
+// "" -> 1, "cm" -> cm, "1/MeV" -> 1/MeV; false for unknown units.
+G4bool UnitValue(const G4String& unit, G4double& value) {
+    if (unit.empty()) {
+        value = 1.;
+        return true;
+    }
+    const G4bool inverse = unit.compare(0, 2, "1/") == 0;
+    const G4String name = inverse ? G4String(unit.substr(2)) : unit;
+    if (!G4UnitDefinition::IsUnitDefined(name)) {
+        return false;
+    }
+    value = G4UnitDefinition::GetValueOf(name);
+    if (inverse) value = 1. / value;
+    return true;
+}
+}
+
+G4String PMMaterialData::GetDataDirectory() {
+    const char* env = std::getenv("PM_DATA_DIR");
+    return (env && *env) ? G4String(env) : G4String("data");
+}
+
+PMMaterialData PMMaterialData::Load(const G4String& fileName) {
+    PMMaterialData data;
+    data.fFileName = GetDataDirectory() + "/" + fileName;
+
+    std::ifstream in(data.fFileName);
+    if (!in) {
+        G4ExceptionDescription msg;
+        msg << "Cannot open material data file " << data.fFileName
+            << " (set PM_DATA_DIR to the directory holding the .dat files)";
+        G4Exception("PMMaterialData::Load", "PMMaterial001", FatalException, msg);
+        std::abort();
+    }
+
+    std::vector<G4double> units;
+    std::string line;
+    G4int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        const std::size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream fields(line);
+        std::string first;
+        if (!(fields >> first)) continue;
+
+        if (first == "columns") {
+            if (!data.fNames.empty()) Invalid(data.fFileName, lineNumber, "second 'columns' line");
+            std::string column;
+            while (fields >> column) {
+                const std::size_t colon = column.find(':');
+                const G4String name = column.substr(0, colon);
+                const G4String unit = colon == std::string::npos ? "" : column.substr(colon + 1);
+                G4double value = 1.;
+                if (!UnitValue(unit, value)) Invalid(data.fFileName, lineNumber, "unknown unit " + unit);
+                data.fNames.push_back(name);
+                units.push_back(value);
+            }
+            if (data.fNames.size() < 2 || data.fNames.front() != "energy") {
+                Invalid(data.fFileName, lineNumber, "expected 'columns energy:<unit> NAME[:unit]...'");
+            }
+            data.fColumns.resize(data.fNames.size());
+        } else if (first == "const") {
+            std::string name, unit;
+            G4double value = 0., scale = 1.;
+            if (!(fields >> name >> value)) Invalid(data.fFileName, lineNumber, "expected 'const NAME value [unit]'");
+            fields >> unit;
+            if (!UnitValue(unit, scale)) Invalid(data.fFileName, lineNumber, "unknown unit " + unit);
+            data.fConstants.emplace_back(name, value * scale);
+        } else {
+            if (data.fNames.empty()) Invalid(data.fFileName, lineNumber, "data row before the 'columns' line");
+            std::istringstream row(line);
+            std::vector<G4double> values;
+            G4double value;
+            while (row >> value) values.push_back(value);
+            if (!row.eof()) Invalid(data.fFileName, lineNumber, "not a number");
+            if (values.size() != data.fNames.size()) {
+                std::ostringstream what;
+                what << values.size() << " values for " << data.fNames.size() << " columns";
+                Invalid(data.fFileName, lineNumber, what.str());
+            }
+            for (std::size_t c = 0; c < values.size(); ++c) {
+                if (values[c] < 0.) Invalid(data.fFileName, lineNumber, "negative " + data.fNames[c]);
+                data.fColumns[c].push_back(values[c] * units[c]);
+            }
+            const std::vector<G4double>& energies = data.fColumns.front();
+            if (energies.size() > 1 && !(energies.back() > energies[energies.size() - 2])) {
+                Invalid(data.fFileName, lineNumber, "energies must increase strictly");
+            }
+        }
+    }
+    if (data.fColumns.empty() || data.fColumns.front().size() < 2) {
+        Invalid(data.fFileName, lineNumber, "need a 'columns' line and at least two rows");
+    }
+    return data;
+}
+
+G4int PMMaterialData::FindColumn(const G4String& name) const {
+    for (std::size_t c = 1; c < fNames.size(); ++c) {
+        if (fNames[c] == name) return static_cast<G4int>(c);
+    }
+    return -1;
+}
+
+const std::vector<G4double>& PMMaterialData::GetProperty(const G4String& name) const {
+    const G4int column = FindColumn(name);
+    if (column < 0) {
+        G4ExceptionDescription msg;
+        msg << fFileName << " has no " << name << " column";
+        G4Exception("PMMaterialData::GetProperty", "PMMaterial003", FatalException, msg);
+    }
+    return fColumns[column];
+}
+
+G4MaterialPropertiesTable* PMMaterialData::FillPropertiesTable(G4MaterialPropertiesTable* mpt) const {
+    if (!mpt) mpt = new G4MaterialPropertiesTable();
+    const std::vector<G4double>& energies = GetEnergies();
+    for (std::size_t c = 1; c < fNames.size(); ++c) {
+        mpt->AddProperty(fNames[c], energies, fColumns[c]);
+    }
+    for (const auto& constant : fConstants) {
+        mpt->AddConstProperty(constant.first, constant.second);
+    }
+    return mpt;
+}
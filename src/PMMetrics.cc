@@ -0,0 +1,182 @@
+#include "PMMetrics.hh"
+#include "PMMetricsMessenger.hh"
+#include "PMShard.hh"
+#include "G4Exception.hh"
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+
+G4ThreadLocal PMMetrics::Slot* PMMetrics::fThreadSlot = nullptr;
+
+PMMetrics* PMMetrics::Instance() {
+    static PMMetrics* instance = new PMMetrics();
+    return instance;
+}
+
+PMMetrics::PMMetrics()
+    : fEnabled(false),
+      fInterval(5.),
+      fFileName("metrics"),
+      fRunID(0),
+      fEventsToProcess(0),
+      fStop(false),
+      fMessenger(new PMMetricsMessenger(this)) {}
+
+// The master's run action starts before any worker's, so the slots are
+// clear before the first event.
+void PMMetrics::BeginOfRun(G4int runID, G4int eventsToProcess) {
+    if (!fEnabled) {
+        return;
+    }
+    for (Slot& slot : fSlots) {
+        slot.events.store(0, std::memory_order_relaxed);
+        slot.opticalPhotons.store(0, std::memory_order_relaxed);
+        slot.steps.store(0, std::memory_order_relaxed);
+        slot.edep.store(0., std::memory_order_relaxed);
+        slot.active.store(false, std::memory_order_relaxed);
+    }
+    fRunID = runID;
+    fEventsToProcess = eventsToProcess;
+    fStart = std::chrono::steady_clock::now();
+    fPrevious = Snapshot();
+    fStop = false;
+    Write(false);
+    fThread = std::thread(&PMMetrics::WriterLoop, this);
+}
+
+void PMMetrics::BeginOfThreadRun() {
+    if (!fEnabled) {
+        fThreadSlot = nullptr;
+        return;
+    }
+    // Sequential mode runs on the master (id -1).
+    const G4int index = std::min(std::max(G4Threading::G4GetThreadId(), 0), kMaxSlots - 1);
+    fThreadSlot = &fSlots[index];
+    fThreadSlot->active.store(true, std::memory_order_relaxed);
+}
+
+void PMMetrics::EndOfRun() {
+    if (!fThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(fWakeMutex);
+        fStop = true;
+    }
+    fWake.notify_one();
+    fThread.join();
+    Write(true);
+}
+
+void PMMetrics::WriterLoop() {
+    const auto interval = std::chrono::duration<G4double>(fInterval);
+    std::unique_lock<std::mutex> lock(fWakeMutex);
+    while (!fWake.wait_for(lock, interval, [this] { return fStop; })) {
+        lock.unlock();
+        Write(false);
+        lock.lock();
+    }
+}
+
+PMMetrics::Snapshot PMMetrics::Sum() const {
+    Snapshot sum;
+    sum.seconds = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - fStart).count();
+    for (const Slot& slot : fSlots) {
+        sum.events += slot.events.load(std::memory_order_relaxed);
+        sum.opticalPhotons += slot.opticalPhotons.load(std::memory_order_relaxed);
+        sum.steps += slot.steps.load(std::memory_order_relaxed);
+        sum.edep += slot.edep.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+// Second field of /proc/self/statm: resident pages.
+G4long PMMetrics::ResidentBytes() {
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0;
+    }
+    long size = 0, resident = 0;
+    const G4bool ok = std::fscanf(statm, "%ld %ld", &size, &resident) == 2;
+    std::fclose(statm);
+    return ok ? resident * sysconf(_SC_PAGESIZE) : 0;
+}
+
+void PMMetrics::Write(G4bool finished) {
+    const Snapshot now = Sum();
+    const G4double window = now.seconds - fPrevious.seconds;
+    const G4double eventRate = window > 0. ? (now.events - fPrevious.events) / window : 0.;
+    const G4double photonRate = window > 0. ? (now.opticalPhotons - fPrevious.opticalPhotons) / window : 0.;
+    const G4double stepRate = window > 0. ? (now.steps - fPrevious.steps) / window : 0.;
+    const G4double meanRate = now.seconds > 0. ? now.events / now.seconds : 0.;
+    const G4double meanEdep = now.events > 0 ? now.edep / MeV / now.events : 0.;
+    const G4long remaining = std::max<G4long>(0, fEventsToProcess - now.events);
+    const G4double eta = finished ? 0. : (eventRate > 0. ? remaining / eventRate : -1.);
+    const G4long rss = ResidentBytes();
+    fPrevious = now;
+
+    const G4String stem = fFileName + PMShard::Instance()->GetFileSuffix();
+    const G4String jsonFile = stem + ".json";
+    const G4String promFile = stem + ".prom";
+    std::FILE* json = std::fopen((jsonFile + ".tmp").c_str(), "w");
+    std::FILE* prom = std::fopen((promFile + ".tmp").c_str(), "w");
+    if (!json || !prom) {
+        if (json) std::fclose(json);
+        if (prom) std::fclose(prom);
+        G4ExceptionDescription msg;
+        msg << "Cannot write metrics " << jsonFile << " / " << promFile;
+        G4Exception("PMMetrics::Write", "PMOutput004", JustWarning, msg);
+        return;
+    }
+
+    std::fprintf(json,
+                 "{\"run\": %d, \"state\": \"%s\", \"elapsed_s\": %.3f, \"events_done\": %ld, "
+                 "\"events_total\": %d, \"events_per_s\": %.6g, \"events_per_s_mean\": %.6g, "
+                 "\"steps_per_s\": %.6g, \"optical_photons_per_s\": %.6g, \"edep_MeV_mean\": %.6g, "
+                 "\"eta_s\": %.6g, \"rss_bytes\": %ld, \"threads\": [",
+                 fRunID, finished ? "finished" : "running", now.seconds, static_cast<long>(now.events),
+                 fEventsToProcess, eventRate, meanRate, stepRate, photonRate, meanEdep, eta,
+                 static_cast<long>(rss));
+    std::fprintf(prom,
+                 "# HELP pm_events_done Events finished in the current run.\n"
+                 "# TYPE pm_events_done gauge\npm_events_done %ld\n"
+                 "# HELP pm_events_total Events requested for the current run.\n"
+                 "# TYPE pm_events_total gauge\npm_events_total %d\n"
+                 "# HELP pm_events_per_second Event rate over the last interval.\n"
+                 "# TYPE pm_events_per_second gauge\npm_events_per_second %.6g\n"
+                 "# HELP pm_steps_per_second Step rate over the last interval.\n"
+                 "# TYPE pm_steps_per_second gauge\npm_steps_per_second %.6g\n"
+                 "# HELP pm_optical_photons_per_second Optical photon creation rate over the last interval.\n"
+                 "# TYPE pm_optical_photons_per_second gauge\npm_optical_photons_per_second %.6g\n"
+                 "# HELP pm_edep_mev_mean Mean crystal energy deposit per event.\n"
+                 "# TYPE pm_edep_mev_mean gauge\npm_edep_mev_mean %.6g\n"
+                 "# HELP pm_eta_seconds Estimated time to the end of the run (-1: unknown).\n"
+                 "# TYPE pm_eta_seconds gauge\npm_eta_seconds %.6g\n"
+                 "# HELP pm_resident_bytes Resident memory of the process.\n"
+                 "# TYPE pm_resident_bytes gauge\npm_resident_bytes %ld\n"
+                 "# HELP pm_thread_events Events finished per worker thread.\n"
+                 "# TYPE pm_thread_events gauge\n",
+                 static_cast<long>(now.events), fEventsToProcess, eventRate, stepRate, photonRate, meanEdep, eta,
+                 static_cast<long>(rss));
+
+    G4bool first = true;
+    for (G4int i = 0; i < kMaxSlots; ++i) {
+        if (!fSlots[i].active.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        const long events = fSlots[i].events.load(std::memory_order_relaxed);
+        std::fprintf(json, "%s{\"thread\": %d, \"events\": %ld}", first ? "" : ", ", i, events);
+        std::fprintf(prom, "pm_thread_events{thread=\"%d\"} %ld\n", i, events);
+        first = false;
+    }
+    std::fprintf(json, "]}\n");
+
+    const G4bool jsonOk = std::fclose(json) == 0;
+    const G4bool promOk = std::fclose(prom) == 0;
+    if (jsonOk) std::rename((jsonFile + ".tmp").c_str(), jsonFile.c_str());
+    if (promOk) std::rename((promFile + ".tmp").c_str(), promFile.c_str());
+}
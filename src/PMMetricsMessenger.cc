@@ -0,0 +1,63 @@
+#include "PMMetricsMessenger.hh"
+#include "PMMetrics.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4SystemOfUnits.hh"
+
+PMMetricsMessenger::PMMetricsMessenger(PMMetrics* metrics) : fMetrics(metrics) {
+    fDirectory = new G4UIdirectory("/PM/metrics/");
+    fDirectory->SetGuidance("Live run progress written to JSON and Prometheus text files.");
+
+    fEnableCmd = new G4UIcmdWithABool("/PM/metrics/enable", this);
+    fEnableCmd->SetGuidance("Write <file>.json and <file>.prom during the next runs.");
+    fEnableCmd->SetParameterName("enabled", true);
+    fEnableCmd->SetDefaultValue(true);
+    fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEnableCmd->SetToBeBroadcasted(false);
+
+    fIntervalCmd = new G4UIcmdWithADoubleAndUnit("/PM/metrics/interval", this);
+    fIntervalCmd->SetGuidance("Time between two updates of the files.");
+    fIntervalCmd->SetParameterName("interval", false);
+    fIntervalCmd->SetRange("interval > 0.");
+    fIntervalCmd->SetDefaultUnit("s");
+    fIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fIntervalCmd->SetToBeBroadcasted(false);
+
+    fFileCmd = new G4UIcmdWithAString("/PM/metrics/file", this);
+    fFileCmd->SetGuidance("Output stem: <file>.json and <file>.prom.");
+    fFileCmd->SetParameterName("file", false);
+    fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fFileCmd->SetToBeBroadcasted(false);
+}
+
+PMMetricsMessenger::~PMMetricsMessenger() {
+    delete fFileCmd;
+    delete fIntervalCmd;
+    delete fEnableCmd;
+    delete fDirectory;
+}
+
+void PMMetricsMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fEnableCmd) {
+        fMetrics->SetEnabled(G4UIcmdWithABool::GetNewBoolValue(newValue));
+    } else if (command == fIntervalCmd) {
+        fMetrics->SetInterval(G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue) / s);
+    } else if (command == fFileCmd) {
+        fMetrics->SetFileName(newValue);
+    }
+}
+
+G4String PMMetricsMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fEnableCmd) {
+        return G4UIcommand::ConvertToString(fMetrics->IsEnabled());
+    }
+    if (command == fIntervalCmd) {
+        return fIntervalCmd->ConvertToString(fMetrics->GetInterval() * s, "s");
+    }
+    if (command == fFileCmd) {
+        return fMetrics->GetFileName();
+    }
+    return "";
+}
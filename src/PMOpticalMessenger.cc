@@ -0,0 +1,113 @@
+#include "PMOpticalMessenger.hh"
+#include "PMOpticalResponse.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+#include <sstream>
+
+PMOpticalMessenger::PMOpticalMessenger(PMOpticalResponse* response) : fResponse(response) {
+    fDirectory = new G4UIdirectory("/PM/optical/");
+    fDirectory->SetGuidance("Optical photon transport mode.");
+
+    fModeCmd = new G4UIcmdWithAString("/PM/optical/mode", this);
+    fModeCmd->SetGuidance("full: track every optical photon.");
+    fModeCmd->SetGuidance("calibrate: full tracking, and build the light-collection map.");
+    fModeCmd->SetGuidance("fast: kill photons at birth and sample detection from the map.");
+    fModeCmd->SetGuidance("off: kill photons at birth without detection (gamma/electron transport only).");
+    fModeCmd->SetParameterName("mode", false);
+    fModeCmd->SetCandidates("full calibrate fast off");
+    fModeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fModeCmd->SetToBeBroadcasted(false);
+
+    fMapFileCmd = new G4UIcmdWithAString("/PM/optical/mapFile", this);
+    fMapFileCmd->SetGuidance("Light-collection map written by calibrate and read by fast.");
+    fMapFileCmd->SetParameterName("file", false);
+    fMapFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fMapFileCmd->SetToBeBroadcasted(false);
+
+    fMapBinsCmd = new G4UIcommand("/PM/optical/mapBins", this);
+    fMapBinsCmd->SetGuidance("Map binning: voxels along x, y, z of the crystal and wavelength bins.");
+    const char* names[4] = {"nx", "ny", "nz", "nWavelength"};
+    const char* defaults[4] = {"10", "10", "3", "8"};
+    for (G4int i = 0; i < 4; ++i) {
+        auto* parameter = new G4UIparameter(names[i], 'i', false);
+        parameter->SetDefaultValue(defaults[i]);
+        parameter->SetParameterRange(G4String(names[i]) + " > 0");
+        fMapBinsCmd->SetParameter(parameter);
+    }
+    fMapBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fMapBinsCmd->SetToBeBroadcasted(false);
+
+    fKeepFractionCmd = new G4UIcmdWithADouble("/PM/optical/keepFraction", this);
+    fKeepFractionCmd->SetGuidance("Track only this fraction of new optical photons, each with weight 1/f.");
+    fKeepFractionCmd->SetParameterName("f", false);
+    fKeepFractionCmd->SetRange("f > 0 && f <= 1");
+    fKeepFractionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fKeepFractionCmd->SetToBeBroadcasted(false);
+
+    fRouletteBouncesCmd = new G4UIcmdWithAnInteger("/PM/optical/rouletteAfter", this);
+    fRouletteBouncesCmd->SetGuidance("Play Russian roulette on a photon every N boundary interactions (0: off).");
+    fRouletteBouncesCmd->SetParameterName("N", false);
+    fRouletteBouncesCmd->SetRange("N >= 0");
+    fRouletteBouncesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fRouletteBouncesCmd->SetToBeBroadcasted(false);
+
+    fRouletteSurvivalCmd = new G4UIcmdWithADouble("/PM/optical/rouletteSurvival", this);
+    fRouletteSurvivalCmd->SetGuidance("Roulette survival probability p; survivors get weight x 1/p.");
+    fRouletteSurvivalCmd->SetParameterName("p", false);
+    fRouletteSurvivalCmd->SetRange("p > 0 && p <= 1");
+    fRouletteSurvivalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fRouletteSurvivalCmd->SetToBeBroadcasted(false);
+}
+
+PMOpticalMessenger::~PMOpticalMessenger() {
+    delete fRouletteSurvivalCmd;
+    delete fRouletteBouncesCmd;
+    delete fKeepFractionCmd;
+    delete fMapBinsCmd;
+    delete fMapFileCmd;
+    delete fModeCmd;
+    delete fDirectory;
+}
+
+void PMOpticalMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fModeCmd) {
+        fResponse->SetMode(PMOpticalResponse::ParseMode(newValue));
+    } else if (command == fMapFileCmd) {
+        fResponse->SetMapFile(newValue);
+    } else if (command == fMapBinsCmd) {
+        std::istringstream is(newValue);
+        G4int nx, ny, nz, nWavelength;
+        is >> nx >> ny >> nz >> nWavelength;
+        fResponse->SetBinning(nx, ny, nz, nWavelength);
+    } else if (command == fKeepFractionCmd) {
+        fResponse->SetKeepFraction(G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+    } else if (command == fRouletteBouncesCmd) {
+        fResponse->SetRouletteBounces(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+    } else if (command == fRouletteSurvivalCmd) {
+        fResponse->SetRouletteSurvival(G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+    }
+}
+
+G4String PMOpticalMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fModeCmd) {
+        return PMOpticalResponse::ModeName(fResponse->GetMode());
+    }
+    if (command == fMapFileCmd) {
+        return fResponse->GetMapFile();
+    }
+    if (command == fKeepFractionCmd) {
+        return G4UIcommand::ConvertToString(fResponse->GetKeepFraction());
+    }
+    if (command == fRouletteBouncesCmd) {
+        return G4UIcommand::ConvertToString(fResponse->GetRouletteBounces());
+    }
+    if (command == fRouletteSurvivalCmd) {
+        return G4UIcommand::ConvertToString(fResponse->GetRouletteSurvival());
+    }
+    return "";
+}
@@ -0,0 +1,110 @@
+#include "PMOpticalResponse.hh"
+#include "PMOpticalMessenger.hh"
+#include "PMLog.hh"
+#include "G4AutoLock.hh"
+#include "G4Exception.hh"
+#include "G4SystemOfUnits.hh"
+
+G4ThreadLocal PMLightCollectionMap* PMOpticalResponse::fThreadMap = nullptr;
+
+PMOpticalResponse::PMOpticalResponse()
+    : fMode(kFull),
+      fKeepFraction(1.),
+      fRouletteBounces(0),
+      fRouletteSurvival(0.5),
+      fMapFile("light_collection_map.bin"),
+      fNx(10), fNy(10), fNz(3), fNWavelength(8),
+      fCrystalHalfSize(5. * cm, 5. * cm, 1.5 * cm),
+      fMessenger(new PMOpticalMessenger(this)) {}
+
+PMOpticalResponse* PMOpticalResponse::Instance() {
+    static PMOpticalResponse* instance = new PMOpticalResponse();
+    return instance;
+}
+
+PMOpticalResponse::Mode PMOpticalResponse::ParseMode(const G4String& name) {
+    if (name == "calibrate") return kCalibrate;
+    if (name == "fast")      return kFast;
+    if (name == "off")       return kOff;
+    return kFull;
+}
+
+const char* PMOpticalResponse::ModeName(Mode mode) {
+    switch (mode) {
+        case kCalibrate: return "calibrate";
+        case kFast:      return "fast";
+        case kOff:       return "off";
+        default:         return "full";
+    }
+}
+
+void PMOpticalResponse::SetBinning(G4int nx, G4int ny, G4int nz, G4int nWavelength) {
+    fNx = nx;
+    fNy = ny;
+    fNz = nz;
+    fNWavelength = nWavelength;
+}
+
+void PMOpticalResponse::ConfigureMap(PMLightCollectionMap& map) const {
+    // Covers the NaI(Tl) emission band (1.5 - 3.0 eV).
+    map.Configure(fCrystalHalfSize, fNx, fNy, fNz, fNWavelength, 400. * nm, 850. * nm);
+}
+
+void PMOpticalResponse::BeginOfRun() {
+    if ((fMode == kFull || fMode == kCalibrate) && (fKeepFraction < 1. || fRouletteBounces > 0)) {
+        PM_SUMMARY("✔ Optical variance reduction: keep fraction " << fKeepFraction
+                   << ", roulette every " << fRouletteBounces << " bounces with survival "
+                   << fRouletteSurvival);
+    }
+    if (fMode == kCalibrate) {
+        ConfigureMap(fMap);
+        PM_SUMMARY("✔ Optical calibration run: light-collection map "
+                   << fNx << "x" << fNy << "x" << fNz << "x" << fNWavelength
+                   << " will be written to " << fMapFile);
+    } else if (fMode == kFast) {
+        if (!fMap.Load(fMapFile)) {
+            G4ExceptionDescription msg;
+            msg << "Cannot read light-collection map " << fMapFile
+                << "; run once with /PM/optical/mode calibrate first.";
+            G4Exception("PMOpticalResponse::BeginOfRun", "PMOptical001", FatalException, msg);
+            return;
+        }
+        PM_SUMMARY("✔ Fast optical mode: map " << fMapFile << " loaded, mean collection efficiency "
+                   << fMap.GetMeanEfficiency());
+    }
+}
+
+void PMOpticalResponse::EndOfRun() {
+    if (fMode != kCalibrate) {
+        return;
+    }
+    fMap.UpdateEfficiency();
+    if (!fMap.Save(fMapFile)) {
+        G4ExceptionDescription msg;
+        msg << "Cannot write light-collection map " << fMapFile;
+        G4Exception("PMOpticalResponse::EndOfRun", "PMOptical002", JustWarning, msg);
+        return;
+    }
+    PM_SUMMARY("✔ Light-collection map written to " << fMapFile << ": "
+               << fMap.GetTotalDetected() << " / " << fMap.GetTotalEmitted()
+               << " photons detected (mean efficiency " << fMap.GetMeanEfficiency() << ")");
+}
+
+void PMOpticalResponse::BeginOfThreadRun() {
+    if (fMode != kCalibrate) {
+        return;
+    }
+    if (!fThreadMap) {
+        fThreadMap = new PMLightCollectionMap();
+    }
+    ConfigureMap(*fThreadMap);
+}
+
+void PMOpticalResponse::MergeThreadMap() {
+    if (fMode != kCalibrate || !fThreadMap) {
+        return;
+    }
+    G4AutoLock lock(&fMergeMutex);
+    fMap.Add(*fThreadMap);
+    fThreadMap->Reset();
+}
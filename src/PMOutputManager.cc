@@ -0,0 +1,51 @@
+#include "PMOutputManager.hh"
+#include "PMOutputMessenger.hh"
+#include "PMShard.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <sstream>
+
+PMOutputManager::PMOutputManager()
+    : fRoot(true),
+      fColumnar(false),
+      fChunkRows(4096),
+      fCompress(true),
+      fPhotonRecords(false),
+      fMessenger(new PMOutputMessenger(this)) {}
+
+PMOutputManager* PMOutputManager::Instance() {
+    static PMOutputManager* instance = new PMOutputManager();
+    return instance;
+}
+
+void PMOutputManager::SetFormat(const G4String& format) {
+    fRoot = (format == "root" || format == "both");
+    fColumnar = (format == "columnar" || format == "both");
+}
+
+G4String PMOutputManager::GetFormat() const {
+    if (fRoot && fColumnar) return "both";
+    if (fColumnar) return "columnar";
+    if (fRoot) return "root";
+    return "none";
+}
+
+G4String PMOutputManager::GetBaseName(G4double energy) const {
+    std::ostringstream name;
+    name << "simulation_output_";
+    if (fTag.empty()) {
+        name << energy / MeV << "MeV";
+    } else {
+        name << fTag;
+    }
+    name << PMShard::Instance()->GetFileSuffix();
+    return name.str();
+}
+
+G4String PMOutputManager::GetThreadFileName(G4double energy, const G4String& suffix) const {
+    std::ostringstream name;
+    name << GetBaseName(energy) << "_t" << std::max(0, G4Threading::G4GetThreadId()) << suffix;
+    return name.str();
+}
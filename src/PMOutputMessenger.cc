@@ -0,0 +1,88 @@
+#include "PMOutputMessenger.hh"
+#include "PMOutputManager.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+
+PMOutputMessenger::PMOutputMessenger(PMOutputManager* manager) : fManager(manager) {
+    fDirectory = new G4UIdirectory("/PM/output/");
+    fDirectory->SetGuidance("Output backends.");
+
+    fFormatCmd = new G4UIcmdWithAString("/PM/output/format", this);
+    fFormatCmd->SetGuidance("root: merged ROOT ntuples; columnar: per-worker .pmc files.");
+    fFormatCmd->SetParameterName("format", false);
+    fFormatCmd->SetCandidates("root columnar both none");
+    fFormatCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fFormatCmd->SetToBeBroadcasted(false);
+
+    fChunkRowsCmd = new G4UIcmdWithAnInteger("/PM/output/chunkRows", this);
+    fChunkRowsCmd->SetGuidance("Rows per columnar chunk.");
+    fChunkRowsCmd->SetParameterName("rows", false);
+    fChunkRowsCmd->SetRange("rows > 0");
+    fChunkRowsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fChunkRowsCmd->SetToBeBroadcasted(false);
+
+    fCompressCmd = new G4UIcmdWithABool("/PM/output/compress", this);
+    fCompressCmd->SetGuidance("Compress columnar chunks with zlib (when available).");
+    fCompressCmd->SetParameterName("compress", false);
+    fCompressCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fCompressCmd->SetToBeBroadcasted(false);
+
+    fPhotonsCmd = new G4UIcmdWithABool("/PM/output/photons", this);
+    fPhotonsCmd->SetGuidance("Record every optical photon reaching the aluminum window:");
+    fPhotonsCmd->SetGuidance("arrival point, time, wavelength, bounce count and creation point.");
+    fPhotonsCmd->SetParameterName("enable", false);
+    fPhotonsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fPhotonsCmd->SetToBeBroadcasted(false);
+
+    fTagCmd = new G4UIcmdWithAString("/PM/output/tag", this);
+    fTagCmd->SetGuidance("Label used in output file names instead of the gun energy.");
+    fTagCmd->SetGuidance("An empty string (\"\") restores the default naming.");
+    fTagCmd->SetParameterName("tag", true);
+    fTagCmd->SetDefaultValue("");
+    fTagCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fTagCmd->SetToBeBroadcasted(false);
+}
+
+PMOutputMessenger::~PMOutputMessenger() {
+    delete fTagCmd;
+    delete fPhotonsCmd;
+    delete fCompressCmd;
+    delete fChunkRowsCmd;
+    delete fFormatCmd;
+    delete fDirectory;
+}
+
+void PMOutputMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fFormatCmd) {
+        fManager->SetFormat(newValue);
+    } else if (command == fChunkRowsCmd) {
+        fManager->SetChunkRows(fChunkRowsCmd->GetNewIntValue(newValue));
+    } else if (command == fCompressCmd) {
+        fManager->SetCompress(fCompressCmd->GetNewBoolValue(newValue));
+    } else if (command == fPhotonsCmd) {
+        fManager->SetPhotonRecording(fPhotonsCmd->GetNewBoolValue(newValue));
+    } else if (command == fTagCmd) {
+        fManager->SetTag(newValue == "\"\"" ? G4String() : newValue);
+    }
+}
+
+G4String PMOutputMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fFormatCmd) {
+        return fManager->GetFormat();
+    }
+    if (command == fChunkRowsCmd) {
+        return fChunkRowsCmd->ConvertToString(fManager->GetChunkRows());
+    }
+    if (command == fCompressCmd) {
+        return fCompressCmd->ConvertToString(fManager->GetCompress());
+    }
+    if (command == fPhotonsCmd) {
+        return fPhotonsCmd->ConvertToString(fManager->IsPhotonRecordingEnabled());
+    }
+    if (command == fTagCmd) {
+        return fManager->GetTag();
+    }
+    return "";
+}
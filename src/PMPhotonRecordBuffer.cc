@@ -0,0 +1,31 @@
+#include "PMPhotonRecordBuffer.hh"
+
+PMPhotonRecordBuffer::PMPhotonRecordBuffer() {
+    Reserve(4096);
+}
+
+void PMPhotonRecordBuffer::Clear() {
+    fX.clear();
+    fY.clear();
+    fZ.clear();
+    fTime.clear();
+    fWavelength.clear();
+    fBounces.clear();
+    fCreationX.clear();
+    fCreationY.clear();
+    fCreationZ.clear();
+    fWeight.clear();
+}
+
+void PMPhotonRecordBuffer::Reserve(std::size_t n) {
+    fX.reserve(n);
+    fY.reserve(n);
+    fZ.reserve(n);
+    fTime.reserve(n);
+    fWavelength.reserve(n);
+    fBounces.reserve(n);
+    fCreationX.reserve(n);
+    fCreationY.reserve(n);
+    fCreationZ.reserve(n);
+    fWeight.reserve(n);
+}
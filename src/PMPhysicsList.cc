@@ -7,14 +7,10 @@
 #include "G4IonPhysics.hh"
 #include "G4StoppingPhysics.hh"
 #include "G4OpticalParameters.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4Exception.hh"
 
 #include "G4OpticalPhoton.hh"
-#include "G4ProcessManager.hh"
-#include "G4Scintillation.hh"
-#include "G4Cerenkov.hh"
-#include "G4Gamma.hh"
-#include "G4Electron.hh"
-#include "G4Positron.hh"
 
 #include "G4BosonConstructor.hh"
 #include "G4LeptonConstructor.hh"
@@ -23,22 +19,47 @@
 #include "G4IonConstructor.hh"
 #include "G4ShortLivedConstructor.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4Version.hh"
+#include "PMLog.hh"
+#include "PMStartupProfiler.hh"
 
-PMPhysicsList::PMPhysicsList() : G4VModularPhysicsList() {
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+const char* kTableCacheMarker = "complete";
+}
+
+PMPhysicsList::PMPhysicsList(const G4String& config) : G4VModularPhysicsList(), fConfig(config) {
     SetVerboseLevel(1);  
+
+    if (fConfig != "full" && fConfig != "lean") {
+        G4ExceptionDescription msg;
+        msg << "Unknown physics configuration '" << fConfig << "' (expected full or lean)";
+        G4Exception("PMPhysicsList::PMPhysicsList", "PMPhysics001", FatalException, msg);
+    }
     
     RegisterPhysics(new G4EmStandardPhysics());
-    RegisterPhysics(new G4DecayPhysics());
-    RegisterPhysics(new G4RadioactiveDecayPhysics());
-    RegisterPhysics(new G4HadronPhysicsQGSP_BERT_HP());
-    RegisterPhysics(new G4IonPhysics());
-    RegisterPhysics(new G4StoppingPhysics());
+    if (!IsLean()) {
+        RegisterPhysics(new G4DecayPhysics());
+        RegisterPhysics(new G4RadioactiveDecayPhysics());
+        RegisterPhysics(new G4HadronPhysicsQGSP_BERT_HP());
+        RegisterPhysics(new G4IonPhysics());
+        RegisterPhysics(new G4StoppingPhysics());
+    }
 
     auto opticalPhysics = new G4OpticalPhysics();
     RegisterPhysics(opticalPhysics);
 
+    // Lets PMFastScintillatorModel take over electrons in the crystals.
+    auto* fastSimulation = new G4FastSimulationPhysics();
+    fastSimulation->ActivateFastSimulation("e-");
+    RegisterPhysics(fastSimulation);
+
     auto* opticalParams = G4OpticalParameters::Instance();
-    opticalParams->SetScintByParticleType(true);
+    opticalParams->SetScintByParticleType(false);
     opticalParams->SetScintStackPhotons(true);
     opticalParams->SetScintTrackInfo(true);
     opticalParams->SetScintTrackSecondariesFirst(true);
@@ -48,12 +69,21 @@ PMPhysicsList::PMPhysicsList() : G4VModularPhysicsList() {
     opticalParams->SetCerenkovMaxBetaChange(10.0);
     opticalParams->SetCerenkovTrackSecondariesFirst(true);
 
-    G4cout << "✔ Physics List Loaded Successfully!\n" << G4endl;
+    PM_SUMMARY("✔ Physics List Loaded Successfully! (" << fConfig << ")\n");
 }
 
 PMPhysicsList::~PMPhysicsList() {}
 
 void PMPhysicsList::ConstructParticle() {
+    PMStartupScope profile("particles");
+    if (IsLean()) {
+        // Each constructor builds only what it needs: the minimal EM set
+        // (leptons, light hadrons, ions for ionisation) and the optical photon.
+        G4VModularPhysicsList::ConstructParticle();
+        G4OpticalPhoton::OpticalPhotonDefinition();
+        return;
+    }
+
     G4BosonConstructor bosons;
     bosons.ConstructParticle();
 
@@ -75,57 +105,22 @@ void PMPhysicsList::ConstructParticle() {
     G4OpticalPhoton::OpticalPhotonDefinition();
 }
 
+// G4OpticalPhysics attaches the only G4Scintillation and G4Cerenkov
+// instances, configured through G4OpticalParameters in the constructor.
+// Registering a second pair here would double the light yield and leave
+// one instance outside PMStackingAction's lazy-stacking switch.
 void PMPhysicsList::ConstructProcess() {
+    PMStartupScope profile("processes");
     G4VModularPhysicsList::ConstructProcess();
 
-    G4OpticalParameters* params = G4OpticalParameters::Instance();
-
-    params->SetScintByParticleType(true);
-    params->SetScintStackPhotons(true);
-    params->SetScintTrackInfo(true);
-    params->SetScintTrackSecondariesFirst(true);
-
-    params->SetCerenkovStackPhotons(true);
-    params->SetCerenkovMaxPhotonsPerStep(300);
-    params->SetCerenkovMaxBetaChange(10.0);
-    params->SetCerenkovTrackSecondariesFirst(true);
-
-    auto* scintillation = new G4Scintillation();
-    scintillation->SetTrackSecondariesFirst(true);
-    scintillation->SetVerboseLevel(1);  
-    scintillation->SetScintillationByParticleType(true);
-
-    auto* cerenkov = new G4Cerenkov();
-    cerenkov->SetTrackSecondariesFirst(true);
-    cerenkov->SetMaxNumPhotonsPerStep(500);
-    cerenkov->SetMaxBetaChangePerStep(10.0);
-
-    G4ProcessManager* gammaManager = G4Gamma::GammaDefinition()->GetProcessManager();
-    if (gammaManager) {
-        gammaManager->AddProcess(scintillation, -1, -1, 1);
-    }
-
-    G4ProcessManager* eMinusManager = G4Electron::ElectronDefinition()->GetProcessManager();
-    if (eMinusManager) {
-        eMinusManager->AddProcess(scintillation, -1, -1, 1);
-        eMinusManager->AddProcess(cerenkov, -1, -1, 2);
-    }
-
-    G4ProcessManager* positronManager = G4Positron::PositronDefinition()->GetProcessManager();
-    if (positronManager) {
-        positronManager->AddProcess(scintillation, -1, -1, 1);
-        positronManager->AddProcess(cerenkov, -1, -1, 2);
-    }
-
-    G4cout << "\n=== Physics Process Construction ===" << G4endl;
-    G4cout << "✔ Standard EM Physics enabled" << G4endl;
-    G4cout << "✔ Optical Physics (Scintillation & Cerenkov) enabled" << G4endl;
-    G4cout << "✔ Scintillation Process added to Gamma, Electrons, and Positrons" << G4endl;
-    G4cout << "✔ Cerenkov Process added to Electrons and Positrons" << G4endl;
-    G4cout << "=================================\n" << G4endl;
+    PM_SUMMARY("\n=== Physics Process Construction ===\n"
+               << "✔ Standard EM Physics enabled\n"
+               << "✔ Optical Physics (Scintillation & Cerenkov) enabled\n"
+               << "=================================\n");
 }
 
 void PMPhysicsList::SetCuts() {
+    PMStartupScope profile("cuts");
     SetCutsWithDefault();
     SetCutValue(0.01 * mm, "gamma");
     SetCutValue(0.01 * mm, "e-");
@@ -133,11 +128,57 @@ void PMPhysicsList::SetCuts() {
     SetCutValue(0.01 * mm, "proton");
     SetCutValue(0.01 * mm, "opticalphoton");
 
-    G4cout << "\n=== Production Cuts Set ===" << G4endl;
-    G4cout << "✔ Gamma cut: 0.01 mm" << G4endl;
-    G4cout << "✔ Electron cut: 0.01 mm" << G4endl;
-    G4cout << "✔ Positron cut: 0.01 mm" << G4endl;
-    G4cout << "✔ Proton cut: 0.01 mm" << G4endl;
-    G4cout << "✔ opticalphoton cut: 0.01 mm" << G4endl;
-    G4cout << "====================================\n" << G4endl;
+    PM_SUMMARY("\n=== Production Cuts Set ===\n"
+               << "✔ Gamma cut: 0.01 mm\n"
+               << "✔ Electron cut: 0.01 mm\n"
+               << "✔ Positron cut: 0.01 mm\n"
+               << "✔ Proton cut: 0.01 mm\n"
+               << "✔ opticalphoton cut: 0.01 mm\n"
+               << "====================================\n");
+
+    if (G4Threading::IsMasterThread()) {
+        PrepareTableCache();
+        PMStartupProfiler::Instance()->MarkPhysicsInitialized();
+    }
+}
+
+G4String PMPhysicsList::GetTableCacheKey() const {
+    std::ostringstream key;
+    key << fConfig << "_g4v" << G4VERSION_NUMBER;
+    for (const char* particle : {"gamma", "e-", "e+", "proton"}) {
+        key << "_" << particle << GetCutValue(particle) / um << "um";
+    }
+    return key.str();
+}
+
+void PMPhysicsList::PrepareTableCache() {
+    fStoreTableCache = false;
+    if (fTableCacheDir.empty()) return;
+
+    fTableCachePath = fTableCacheDir + "/" + GetTableCacheKey();
+    if (std::filesystem::exists(std::string(fTableCachePath) + "/" + kTableCacheMarker)) {
+        // Falls back to building the tables if the stored cuts or
+        // materials do not match this geometry.
+        SetPhysicsTableRetrieved(fTableCachePath);
+        PM_SUMMARY("✔ Retrieving physics tables from " << fTableCachePath);
+    } else {
+        fStoreTableCache = true;
+        PM_SUMMARY("✔ Physics tables will be stored in " << fTableCachePath);
+    }
+}
+
+void PMPhysicsList::StoreTableCache() {
+    if (!fStoreTableCache) return;
+    fStoreTableCache = false;
+
+    std::error_code error;
+    std::filesystem::create_directories(std::string(fTableCachePath), error);
+    if (error || !StorePhysicsTable(fTableCachePath)) {
+        G4ExceptionDescription msg;
+        msg << "Could not store physics tables in " << fTableCachePath;
+        G4Exception("PMPhysicsList::StoreTableCache", "PMPhysics002", JustWarning, msg);
+        return;
+    }
+    std::ofstream(std::string(fTableCachePath) + "/" + kTableCacheMarker) << GetTableCacheKey() << "\n";
+    PM_SUMMARY("✔ Physics tables stored in " << fTableCachePath);
 }
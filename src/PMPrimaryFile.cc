@@ -0,0 +1,81 @@
+#include "PMPrimaryFile.hh"
+#include "G4Exception.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+PMPrimaryFile::~PMPrimaryFile() {
+    Close();
+}
+
+G4bool PMPrimaryFile::Open(const G4String& fileName) {
+    Close();
+
+    G4ExceptionDescription msg;
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) != 0) {
+        if (fd >= 0) ::close(fd);
+        msg << "Cannot open primary file " << fileName;
+        G4Exception("PMPrimaryFile::Open", "PMGun001", JustWarning, msg);
+        return false;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* data = (size >= sizeof(PMPrimaries::FileHeader))
+                     ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        msg << "Cannot map primary file " << fileName;
+        G4Exception("PMPrimaryFile::Open", "PMGun001", JustWarning, msg);
+        return false;
+    }
+
+    const auto* header = static_cast<const PMPrimaries::FileHeader*>(data);
+    const char* bytes = static_cast<const char*>(data);
+    // Both counts are bounded by the file size before they are multiplied,
+    // so a corrupt header cannot wrap the size check below around.
+    const G4bool valid =
+        std::memcmp(header->magic, PMPrimaries::kFileMagic, sizeof(header->magic)) == 0 &&
+        header->nEvents > 0 && header->nEvents < size / sizeof(std::uint64_t) &&
+        header->nRecords <= size / sizeof(PMPrimaries::Record) &&
+        PMPrimaries::RecordOffset(header->nEvents) + header->nRecords * sizeof(PMPrimaries::Record) == size;
+    const auto* index = reinterpret_cast<const std::uint64_t*>(bytes + PMPrimaries::IndexOffset());
+    G4bool ordered = valid && index[0] == 0 && index[header->nEvents] == header->nRecords;
+    for (std::uint64_t i = 0; ordered && i < header->nEvents; ++i) {
+        ordered = index[i] <= index[i + 1];
+    }
+    if (!ordered) {
+        ::munmap(data, size);
+        msg << fileName << " is not a valid primary file (see PMPrimaryFormat.hh)";
+        G4Exception("PMPrimaryFile::Open", "PMGun002", JustWarning, msg);
+        return false;
+    }
+
+    // Sequential replay touches every page once; let the kernel read ahead.
+    ::madvise(data, size, MADV_SEQUENTIAL);
+
+    fFileName = fileName;
+    fData = data;
+    fSize = size;
+    fNEvents = header->nEvents;
+    fIndex = index;
+    fRecords = reinterpret_cast<const PMPrimaries::Record*>(bytes + PMPrimaries::RecordOffset(fNEvents));
+    return true;
+}
+
+void PMPrimaryFile::Close() {
+    if (fData) {
+        ::munmap(fData, fSize);
+    }
+    fFileName = "";
+    fData = nullptr;
+    fSize = 0;
+    fNEvents = 0;
+    fIndex = nullptr;
+    fRecords = nullptr;
+}
@@ -5,6 +5,39 @@
 #include "Randomize.hh"
 #include "G4Gamma.hh"
 #include "G4PhysicalConstants.hh"
+#include "PMLog.hh"
+#include "PMPrimaryGeneratorMessenger.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4Exception.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "PMShard.hh"
+#include "PMAllocCounter.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace {
+struct IsotopeLine {
+    const char* isotope;
+    G4double energy;
+    G4double intensity;  // photons per decay
+    G4bool pair;
+};
+
+// Gamma and X-ray lines above 1% per decay (ENSDF).
+const IsotopeLine kIsotopeLines[] = {
+    {"Cs137", 661.657 * keV,  0.851,    false},
+    {"Cs137", 32.194 * keV,   0.0364,   false},  // Ba K-alpha1
+    {"Cs137", 31.817 * keV,   0.0199,   false},  // Ba K-alpha2
+    {"Co60",  1173.228 * keV, 0.9985,   false},
+    {"Co60",  1332.492 * keV, 0.999826, false},
+    {"Na22",  1274.537 * keV, 0.9994,   false},
+    {"Na22",  510.999 * keV,  0.9038,   true},   // beta+ annihilation
+};
+}
 
 PMPrimaryGenerator::PMPrimaryGenerator(G4double energy) {
     fParticleGun = new G4ParticleGun(1);
@@ -20,29 +53,78 @@ PMPrimaryGenerator::PMPrimaryGenerator(G4double energy) {
     fSourceRadius = 2.0 * mm;
     fBeamSpreadAngle = 5.0 * deg;
 
-    G4cout << "✅ Gamma energy set to " << fBaseEnergy / MeV << " MeV (from input)" << G4endl;
+    fSource = kGun;
+    fDecaysPerEvent = 1;
+    fLastPdg = 0;
+    fLastParticle = nullptr;
+
+    fMessenger = new PMPrimaryGeneratorMessenger(this);
+
+    PM_DEBUG("✅ Gamma energy set to " << fBaseEnergy / MeV << " MeV (from input)");
 }
 
 PMPrimaryGenerator::~PMPrimaryGenerator() {
+    delete fMessenger;
     delete fParticleGun;
 }
 
-void PMPrimaryGenerator::UpdatePositionAndDirection() {
+void PMPrimaryGenerator::SetGammaEnergy(G4double energy) {
+    fBaseEnergy = energy;
+}
+
+void PMPrimaryGenerator::SetSourceDistance(G4double distance) {
+    fSourcePosZ = -distance;
+}
+
+void PMPrimaryGenerator::SetSourceRadius(G4double radius) {
+    fSourceRadius = radius;
+}
+
+void PMPrimaryGenerator::SetBeamSpreadAngle(G4double angle) {
+    fBeamSpreadAngle = angle;
+}
+
+void PMPrimaryGenerator::SetEnergySigma(G4double sigma) {
+    fEnergySigma = sigma;
+}
+
+G4double PMPrimaryGenerator::GetGammaEnergy() const {
+    return fBaseEnergy;
+}
+
+G4double PMPrimaryGenerator::GetSourceDistance() const {
+    return -fSourcePosZ;
+}
+
+G4double PMPrimaryGenerator::GetSourceRadius() const {
+    return fSourceRadius;
+}
+
+G4double PMPrimaryGenerator::GetBeamSpreadAngle() const {
+    return fBeamSpreadAngle;
+}
+
+G4double PMPrimaryGenerator::GetEnergySigma() const {
+    return fEnergySigma;
+}
+
+G4ThreeVector PMPrimaryGenerator::SamplePosition() const {
     G4double r = fSourceRadius * std::sqrt(G4UniformRand());
     G4double phi = 2.0 * pi * G4UniformRand();
-    G4double x = r * std::cos(phi);
-    G4double y = r * std::sin(phi);
-    
-    fParticleGun->SetParticlePosition(G4ThreeVector(x, y, fSourcePosZ));
+    return G4ThreeVector(r * std::cos(phi), r * std::sin(phi), fSourcePosZ);
+}
 
+G4ThreeVector PMPrimaryGenerator::SampleDirection() const {
     G4double theta = fBeamSpreadAngle * std::sqrt(G4UniformRand());
     G4double dirPhi = 2.0 * pi * G4UniformRand();
-    
-    G4double dx = std::sin(theta) * std::cos(dirPhi);
-    G4double dy = std::sin(theta) * std::sin(dirPhi);
-    G4double dz = std::cos(theta);
-    
-    fParticleGun->SetParticleMomentumDirection(G4ThreeVector(dx, dy, dz));
+    return G4ThreeVector(std::sin(theta) * std::cos(dirPhi),
+                         std::sin(theta) * std::sin(dirPhi),
+                         std::cos(theta));
+}
+
+void PMPrimaryGenerator::UpdatePositionAndDirection() {
+    fParticleGun->SetParticlePosition(SamplePosition());
+    fParticleGun->SetParticleMomentumDirection(SampleDirection());
 
     G4double energy = G4RandGauss::shoot(fBaseEnergy, fEnergySigma);
     energy = std::max(energy, 1 * keV);
@@ -50,11 +132,178 @@ void PMPrimaryGenerator::UpdatePositionAndDirection() {
     fParticleGun->SetParticleEnergy(energy);
 }
 
+const char* PMPrimaryGenerator::SourceName(Source source) {
+    switch (source) {
+        case kIsotope:  return "isotope";
+        case kSpectrum: return "spectrum";
+        case kFile:     return "file";
+        default:        return "gun";
+    }
+}
+
+G4bool PMPrimaryGenerator::SetSource(const G4String& name) {
+    for (Source source : {kGun, kIsotope, kSpectrum, kFile}) {
+        if (name != SourceName(source)) continue;
+        if ((source == kIsotope && fIsotopeLines.empty()) || (source == kSpectrum && fSpectrum.empty()) ||
+            (source == kFile && !fPrimaryFile.IsOpen())) {
+            G4ExceptionDescription msg;
+            msg << "Source '" << name << "' selected before /PM/gun/"
+                << (source == kIsotope ? "isotope" : source == kSpectrum ? "spectrum" : "file")
+                << "; keeping '" << SourceName(fSource) << "'";
+            G4Exception("PMPrimaryGenerator::SetSource", "PMGun003", JustWarning, msg);
+            return false;
+        }
+        fSource = source;
+        return true;
+    }
+    return false;
+}
+
+G4bool PMPrimaryGenerator::SetIsotope(const G4String& name) {
+    std::vector<Line> lines;
+    for (const IsotopeLine& line : kIsotopeLines) {
+        if (name == line.isotope) {
+            lines.push_back({line.energy, line.intensity, line.pair});
+        }
+    }
+    if (lines.empty()) {
+        G4ExceptionDescription msg;
+        msg << "Unknown isotope " << name << " (Cs137, Co60 or Na22)";
+        G4Exception("PMPrimaryGenerator::SetIsotope", "PMGun003", JustWarning, msg);
+        return false;
+    }
+    fIsotope = name;
+    fIsotopeLines.swap(lines);
+    fSource = kIsotope;
+    return true;
+}
+
+// "energy[keV] weight" per line, '#' starts a comment.
+G4bool PMPrimaryGenerator::LoadSpectrum(const G4String& fileName) {
+    std::ifstream in(fileName);
+    std::vector<Line> lines;
+    G4double total = 0.;
+    std::string text;
+    G4bool valid = static_cast<G4bool>(in);
+    while (valid && std::getline(in, text)) {
+        const std::size_t comment = text.find('#');
+        if (comment != std::string::npos) text.erase(comment);
+        std::istringstream fields(text);
+        G4double energy, weight;
+        if (!(fields >> energy)) continue;
+        valid = static_cast<G4bool>(fields >> weight) && energy > 0. && weight >= 0.;
+        total += weight;
+        lines.push_back({energy * keV, total, false});
+    }
+    if (!valid || total <= 0.) {
+        G4ExceptionDescription msg;
+        msg << "Cannot read spectrum " << fileName << " (expected 'energy[keV] weight' lines)";
+        G4Exception("PMPrimaryGenerator::LoadSpectrum", "PMGun003", JustWarning, msg);
+        return false;
+    }
+    fSpectrumFile = fileName;
+    fSpectrum.swap(lines);
+    fSource = kSpectrum;
+    return true;
+}
+
+G4bool PMPrimaryGenerator::OpenPrimaryFile(const G4String& fileName) {
+    if (!fPrimaryFile.Open(fileName)) {
+        if (fSource == kFile) {
+            fSource = kGun;
+        }
+        return false;
+    }
+    fSource = kFile;
+    PM_SUMMARY("✔ Primary file " << fileName << ": " << fPrimaryFile.GetNumberOfEvents() << " events");
+    return true;
+}
+
+void PMPrimaryGenerator::AddGamma(G4PrimaryVertex* vertex, G4double energy,
+                                  const G4ThreeVector& direction) const {
+    auto* gamma = new G4PrimaryParticle(G4Gamma::GammaDefinition());
+    gamma->SetKineticEnergy(energy);
+    gamma->SetMomentumDirection(direction);
+    vertex->SetPrimary(gamma);
+}
+
+// A decay that emits no photon keeps its (empty) vertex, so every event
+// holds exactly fDecaysPerEvent decays.
+void PMPrimaryGenerator::GenerateDecays(G4Event* event) {
+    for (G4int decay = 0; decay < fDecaysPerEvent; ++decay) {
+        auto* vertex = new G4PrimaryVertex(SamplePosition(), 0.);
+        if (fSource == kIsotope) {
+            for (const Line& line : fIsotopeLines) {
+                if (G4UniformRand() >= line.intensity) continue;
+                const G4ThreeVector direction = SampleDirection();
+                AddGamma(vertex, line.energy, direction);
+                if (line.pair) {
+                    AddGamma(vertex, line.energy, -direction);
+                }
+            }
+        } else {
+            const G4double u = G4UniformRand() * fSpectrum.back().intensity;
+            auto line = std::upper_bound(fSpectrum.begin(), fSpectrum.end(), u,
+                                         [](G4double value, const Line& l) { return value < l.intensity; });
+            if (line == fSpectrum.end()) --line;
+            AddGamma(vertex, line->energy, SampleDirection());
+        }
+        event->AddPrimaryVertex(vertex);
+    }
+}
+
+void PMPrimaryGenerator::GenerateFromFile(G4Event* event) {
+    const G4long eventID = PMShard::Instance()->GetGlobalEventID(event->GetEventID());
+    const std::uint64_t index = static_cast<std::uint64_t>(eventID) % fPrimaryFile.GetNumberOfEvents();
+    for (const PMPrimaries::Record* record = fPrimaryFile.Begin(index); record != fPrimaryFile.End(index); ++record) {
+        if (record->pdg != fLastPdg || !fLastParticle) {
+            fLastPdg = record->pdg;
+            fLastParticle = G4ParticleTable::GetParticleTable()->FindParticle(record->pdg);
+            if (!fLastParticle) {
+                G4ExceptionDescription msg;
+                msg << "Unknown PDG code " << record->pdg << " in " << fPrimaryFile.GetFileName()
+                    << "; particle skipped";
+                G4Exception("PMPrimaryGenerator::GenerateFromFile", "PMGun004", JustWarning, msg);
+                continue;
+            }
+        }
+        auto* vertex = new G4PrimaryVertex(
+            G4ThreeVector(record->position[0], record->position[1], record->position[2]) * mm,
+            record->time * ns);
+        auto* particle = new G4PrimaryParticle(fLastParticle);
+        particle->SetKineticEnergy(record->energy * MeV);
+        particle->SetMomentumDirection(
+            G4ThreeVector(record->direction[0], record->direction[1], record->direction[2]));
+        vertex->SetPrimary(particle);
+        event->AddPrimaryVertex(vertex);
+    }
+}
+
 void PMPrimaryGenerator::GeneratePrimaries(G4Event* anEvent) {
+    PM_ALLOC_SCOPE(kPrimary);
+    // First use of the engine in the event: everything after this depends
+    // only on the global event ID.
+    PMShard* shard = PMShard::Instance();
+    if (shard->IsSeeding()) {
+        shard->SeedEvent(G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID(),
+                         anEvent->GetEventID());
+    }
+
+    if (fSource == kFile) {
+        GenerateFromFile(anEvent);
+        return;
+    }
+    if (fSource != kGun) {
+        GenerateDecays(anEvent);
+        return;
+    }
+
     fParticleGun->SetParticleDefinition(G4Gamma::GammaDefinition());
-    UpdatePositionAndDirection();
-    fParticleGun->GeneratePrimaryVertex(anEvent);
+    for (G4int decay = 0; decay < fDecaysPerEvent; ++decay) {
+        UpdatePositionAndDirection();
+        fParticleGun->GeneratePrimaryVertex(anEvent);
+    }
 
-    G4cout << "🔹 Generating gamma with energy: " 
-           << fParticleGun->GetParticleEnergy() / MeV << " MeV" << G4endl;
+    PM_DEBUG("🔹 Generating gamma with energy: " 
+             << fParticleGun->GetParticleEnergy() / MeV << " MeV");
 }
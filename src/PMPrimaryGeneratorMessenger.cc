@@ -0,0 +1,147 @@
+#include "PMPrimaryGeneratorMessenger.hh"
+#include "PMPrimaryGenerator.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+PMPrimaryGeneratorMessenger::PMPrimaryGeneratorMessenger(PMPrimaryGenerator* generator)
+    : fGenerator(generator) {
+    fDirectory = new G4UIdirectory("/PM/gun/");
+    fDirectory->SetGuidance("Primary source: gamma gun, isotope lines, spectrum table or primary file.");
+
+    fEnergyCmd = new G4UIcmdWithADoubleAndUnit("/PM/gun/energy", this);
+    fEnergyCmd->SetGuidance("Mean gamma energy.");
+    fEnergyCmd->SetParameterName("energy", false);
+    fEnergyCmd->SetRange("energy > 0.");
+    fEnergyCmd->SetDefaultUnit("MeV");
+    fEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fEnergySigmaCmd = new G4UIcmdWithADoubleAndUnit("/PM/gun/energySigma", this);
+    fEnergySigmaCmd->SetGuidance("Gaussian spread of the gamma energy.");
+    fEnergySigmaCmd->SetParameterName("sigma", false);
+    fEnergySigmaCmd->SetRange("sigma >= 0.");
+    fEnergySigmaCmd->SetDefaultUnit("keV");
+    fEnergySigmaCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fDistanceCmd = new G4UIcmdWithADoubleAndUnit("/PM/gun/sourceDistance", this);
+    fDistanceCmd->SetGuidance("Distance of the source disc from the crystal centre along -z.");
+    fDistanceCmd->SetParameterName("distance", false);
+    fDistanceCmd->SetDefaultUnit("cm");
+    fDistanceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fRadiusCmd = new G4UIcmdWithADoubleAndUnit("/PM/gun/sourceRadius", this);
+    fRadiusCmd->SetGuidance("Radius of the source disc.");
+    fRadiusCmd->SetParameterName("radius", false);
+    fRadiusCmd->SetRange("radius >= 0.");
+    fRadiusCmd->SetDefaultUnit("mm");
+    fRadiusCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fSpreadCmd = new G4UIcmdWithADoubleAndUnit("/PM/gun/spreadAngle", this);
+    fSpreadCmd->SetGuidance("Half-opening angle of the emission cone.");
+    fSpreadCmd->SetParameterName("angle", false);
+    fSpreadCmd->SetRange("angle >= 0.");
+    fSpreadCmd->SetDefaultUnit("deg");
+    fSpreadCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fSourceCmd = new G4UIcmdWithAString("/PM/gun/source", this);
+    fSourceCmd->SetGuidance("Switch between already configured sources.");
+    fSourceCmd->SetGuidance("isotope, spectrum and file are also selected by their own commands.");
+    fSourceCmd->SetParameterName("source", false);
+    fSourceCmd->SetCandidates("gun isotope spectrum file");
+    fSourceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fIsotopeCmd = new G4UIcmdWithAString("/PM/gun/isotope", this);
+    fIsotopeCmd->SetGuidance("Emit the gamma lines of this isotope per decay (selects the isotope source).");
+    fIsotopeCmd->SetParameterName("isotope", false);
+    fIsotopeCmd->SetCandidates("Cs137 Co60 Na22");
+    fIsotopeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fSpectrumCmd = new G4UIcmdWithAString("/PM/gun/spectrum", this);
+    fSpectrumCmd->SetGuidance("Load an 'energy[keV] weight' line table (selects the spectrum source).");
+    fSpectrumCmd->SetParameterName("file", false);
+    fSpectrumCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fFileCmd = new G4UIcmdWithAString("/PM/gun/file", this);
+    fFileCmd->SetGuidance("Replay a primary file written by pm_primaries (selects the file source).");
+    fFileCmd->SetParameterName("file", false);
+    fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fDecaysCmd = new G4UIcmdWithAnInteger("/PM/gun/decaysPerEvent", this);
+    fDecaysCmd->SetGuidance("Decays (primary vertices) per event for the gun, isotope and spectrum sources.");
+    fDecaysCmd->SetParameterName("N", false);
+    fDecaysCmd->SetRange("N >= 1");
+    fDecaysCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+PMPrimaryGeneratorMessenger::~PMPrimaryGeneratorMessenger() {
+    delete fDecaysCmd;
+    delete fFileCmd;
+    delete fSpectrumCmd;
+    delete fIsotopeCmd;
+    delete fSourceCmd;
+    delete fSpreadCmd;
+    delete fRadiusCmd;
+    delete fDistanceCmd;
+    delete fEnergySigmaCmd;
+    delete fEnergyCmd;
+    delete fDirectory;
+}
+
+void PMPrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fEnergyCmd) {
+        fGenerator->SetGammaEnergy(fEnergyCmd->GetNewDoubleValue(newValue));
+    } else if (command == fEnergySigmaCmd) {
+        fGenerator->SetEnergySigma(fEnergySigmaCmd->GetNewDoubleValue(newValue));
+    } else if (command == fDistanceCmd) {
+        fGenerator->SetSourceDistance(fDistanceCmd->GetNewDoubleValue(newValue));
+    } else if (command == fRadiusCmd) {
+        fGenerator->SetSourceRadius(fRadiusCmd->GetNewDoubleValue(newValue));
+    } else if (command == fSpreadCmd) {
+        fGenerator->SetBeamSpreadAngle(fSpreadCmd->GetNewDoubleValue(newValue));
+    } else if (command == fSourceCmd) {
+        fGenerator->SetSource(newValue);
+    } else if (command == fIsotopeCmd) {
+        fGenerator->SetIsotope(newValue);
+    } else if (command == fSpectrumCmd) {
+        fGenerator->LoadSpectrum(newValue);
+    } else if (command == fFileCmd) {
+        fGenerator->OpenPrimaryFile(newValue);
+    } else if (command == fDecaysCmd) {
+        fGenerator->SetDecaysPerEvent(fDecaysCmd->GetNewIntValue(newValue));
+    }
+}
+
+G4String PMPrimaryGeneratorMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fEnergyCmd) {
+        return fEnergyCmd->ConvertToString(fGenerator->GetGammaEnergy(), "MeV");
+    }
+    if (command == fEnergySigmaCmd) {
+        return fEnergySigmaCmd->ConvertToString(fGenerator->GetEnergySigma(), "keV");
+    }
+    if (command == fDistanceCmd) {
+        return fDistanceCmd->ConvertToString(fGenerator->GetSourceDistance(), "cm");
+    }
+    if (command == fRadiusCmd) {
+        return fRadiusCmd->ConvertToString(fGenerator->GetSourceRadius(), "mm");
+    }
+    if (command == fSpreadCmd) {
+        return fSpreadCmd->ConvertToString(fGenerator->GetBeamSpreadAngle(), "deg");
+    }
+    if (command == fSourceCmd) {
+        return PMPrimaryGenerator::SourceName(fGenerator->GetSource());
+    }
+    if (command == fIsotopeCmd) {
+        return fGenerator->GetIsotope();
+    }
+    if (command == fSpectrumCmd) {
+        return fGenerator->GetSpectrumFile();
+    }
+    if (command == fFileCmd) {
+        return fGenerator->GetPrimaryFile();
+    }
+    if (command == fDecaysCmd) {
+        return G4UIcommand::ConvertToString(fGenerator->GetDecaysPerEvent());
+    }
+    return "";
+}
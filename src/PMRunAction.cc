@@ -1,46 +1,333 @@
 #include "PMRunAction.hh"
 #include "G4AnalysisManager.hh"
+#include "G4AccumulableManager.hh"
 #include "G4Run.hh"
-#include <sstream>
+#include "PMLog.hh"
+#include "G4Exception.hh"
+#include "PMOpticalResponse.hh"
+#include "PMOutputManager.hh"
+#include "PMColumnarWriter.hh"
+#include "G4Threading.hh"
+#include "G4RunManagerKernel.hh"
+#include "PMPhysicsList.hh"
+#include "PMStartupProfiler.hh"
+#include "PMStepProfiler.hh"
+#include "PMAllocCounter.hh"
+#include "PMScoringMesh.hh"
+#include "PMMetrics.hh"
+#include "PMShard.hh"
+
+#include <cstdio>
+
+PMRunAction::PMRunAction(G4double energy)
+    : fEnergy(energy),
+      fEventWriter(nullptr),
+      fPhotonWriter(nullptr),
+      fOpticalPhotons(0),
+      fAluminumPhotons(0),
+      fAluminumWeight(0.),
+      fScintillationPhotons(0),
+      fGammasAtTeflon(0),
+      fEnergyDeposit(0.),
+      fSteps(0) {
+    G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
+    accumulableManager->RegisterAccumulable(fOpticalPhotons);
+    accumulableManager->RegisterAccumulable(fAluminumPhotons);
+    accumulableManager->RegisterAccumulable(fAluminumWeight);
+    accumulableManager->RegisterAccumulable(fScintillationPhotons);
+    accumulableManager->RegisterAccumulable(fGammasAtTeflon);
+    accumulableManager->RegisterAccumulable(fEnergyDeposit);
+    accumulableManager->RegisterAccumulable(fSteps);
 
-PMRunAction::PMRunAction(G4double energy) : fEnergy(energy) {
     G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
     analysisManager->SetVerboseLevel(1);
 
-    analysisManager->CreateH1("Edep", "Energy deposit", 100, 0., 1.1 * MeV);
-    analysisManager->CreateH1("OpticalPhotons", "Optical Photon Count per Event", 100, 0, 500);
-    analysisManager->CreateH1("GammaTeflon", "Gammas at Teflon Barrier per Event", 100, 0, 100);  // ✅ Güncellendi
+    // Mirrors of the PMHistogramSet booking table; filled only on the master
+    // from the merged set, so H1 IDs equal PMHistID values.
+    for (G4int h = 0; h < static_cast<G4int>(PMHistID::kCount); ++h) {
+        const PMHistogramDef& def = PMHistogramSet::GetDef(static_cast<PMHistID>(h));
+        analysisManager->CreateH1(def.name, def.title, def.nBins, def.min, def.max);
+    }
 
-    analysisManager->CreateNtuple("Photons", "Optical Photons");
+    // Column order follows EventColumn.
+    analysisManager->CreateNtuple("Events", "Per-event summary");
     analysisManager->CreateNtupleIColumn("iEvent");
-    analysisManager->CreateNtupleDColumn("fX");
-    analysisManager->CreateNtupleDColumn("fY");
-    analysisManager->CreateNtupleDColumn("fZ");
-    analysisManager->CreateNtupleDColumn("fGlobalTime");
-    analysisManager->CreateNtupleDColumn("fWlen");
+    analysisManager->CreateNtupleIColumn("nOptical");
+    analysisManager->CreateNtupleIColumn("nGammaTeflon");
+    analysisManager->CreateNtupleIColumn("nAluminum");
+    analysisManager->CreateNtupleIColumn("nScintillation");
     analysisManager->CreateNtupleDColumn("Edep");
+    analysisManager->CreateNtupleDColumn("wAluminum");
+    analysisManager->CreateNtupleDColumn("digiCharge");
+    analysisManager->CreateNtupleDColumn("digiTime");
+    analysisManager->FinishNtuple();
+
+    // One row per event, filled only with /PM/output/photons true. The
+    // vector columns are bound to this thread's photon record buffer.
+    analysisManager->CreateNtuple("Photons", "Optical photons reaching the aluminum window");
+    analysisManager->CreateNtupleIColumn("iEvent");
+    analysisManager->CreateNtupleDColumn("fX", fPhotonRecords.fX);
+    analysisManager->CreateNtupleDColumn("fY", fPhotonRecords.fY);
+    analysisManager->CreateNtupleDColumn("fZ", fPhotonRecords.fZ);
+    analysisManager->CreateNtupleDColumn("fGlobalTime", fPhotonRecords.fTime);
+    analysisManager->CreateNtupleDColumn("fWlen", fPhotonRecords.fWavelength);
+    analysisManager->CreateNtupleIColumn("nBounces", fPhotonRecords.fBounces);
+    analysisManager->CreateNtupleDColumn("fX0", fPhotonRecords.fCreationX);
+    analysisManager->CreateNtupleDColumn("fY0", fPhotonRecords.fCreationY);
+    analysisManager->CreateNtupleDColumn("fZ0", fPhotonRecords.fCreationZ);
+    analysisManager->CreateNtupleDColumn("fWeight", fPhotonRecords.fWeight);
     analysisManager->FinishNtuple();
 }
 
-PMRunAction::~PMRunAction() {}
+PMRunAction::~PMRunAction() {
+    delete fEventWriter;
+    delete fPhotonWriter;
+}
 
 void PMRunAction::BeginOfRunAction(const G4Run *run) {
-    G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
-    std::stringstream filename;
-    filename << "simulation_output_" << fEnergy << "MeV.root";
-    analysisManager->SetFileName(filename.str());
-    analysisManager->SetNtupleMerging(true);
-    analysisManager->OpenFile();
+    G4AccumulableManager::Instance()->Reset();
+
+    // The master's run action starts before any worker's, so shared optical
+    // response state is ready by the time events are tracked.
+    PMOpticalResponse* opticalResponse = PMOpticalResponse::Instance();
+    PMStepProfiler* stepProfiler = PMStepProfiler::Instance();
+    PMAllocCounter* allocCounter = PMAllocCounter::Instance();
+    PMScoringMesh* scoringMesh = PMScoringMesh::Instance();
+    PMMetrics* metrics = PMMetrics::Instance();
+    if (IsMaster()) {
+        opticalResponse->BeginOfRun();
+        stepProfiler->BeginOfRun();
+        allocCounter->BeginOfRun();
+        scoringMesh->BeginOfRun();
+        metrics->BeginOfRun(run->GetRunID(), run->GetNumberOfEventToBeProcessed());
+        PMShard::Instance()->BeginOfRun(run->GetNumberOfEventToBeProcessed());
+    }
+    if (!IsMaster() || !G4Threading::IsMultithreadedApplication()) {
+        opticalResponse->BeginOfThreadRun();
+        stepProfiler->BeginOfThreadRun();
+        allocCounter->BeginOfThreadRun();
+        scoringMesh->BeginOfThreadRun();
+        metrics->BeginOfThreadRun();
+    }
+
+    fHistograms.Reset();
+    if (IsMaster()) {
+        PMHistogramSet::ClearThreadSets();
+    } else {
+        PMHistogramSet::RegisterThreadSet(G4Threading::G4GetThreadId(), &fHistograms);
+    }
+
+    PMOutputManager* output = PMOutputManager::Instance();
+    G4String filename = output->GetBaseName(fEnergy) + ".root";
 
-    G4cout << "Run started with " << fEnergy << " MeV. Data saved in: " 
-           << filename.str() << G4endl;
+    if (output->IsRootEnabled()) {
+        G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
+        analysisManager->SetFileName(filename);
+        analysisManager->SetNtupleMerging(true);
+        analysisManager->OpenFile();
+    }
+
+    if (output->IsColumnarEnabled() && (!IsMaster() || !G4Threading::IsMultithreadedApplication())) {
+        OpenColumnarWriters();
+    }
+
+    if (IsMaster()) {
+        // Tables are built by now: cache them for the next job, then close
+        // the startup profile.
+        if (auto* physicsList = dynamic_cast<PMPhysicsList*>(
+                G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList())) {
+            physicsList->StoreTableCache();
+        }
+        PMStartupProfiler::Instance()->MarkRunStart();
+
+        fTimer.Start();
+        PM_SUMMARY("Run started with " << fEnergy << " MeV. Output format: "
+                   << output->GetFormat() << ", file stem: " << output->GetBaseName(fEnergy));
+    }
 }
 
 void PMRunAction::EndOfRunAction(const G4Run *run) {
+    G4AccumulableManager::Instance()->Merge();
+
+    PMOpticalResponse* opticalResponse = PMOpticalResponse::Instance();
+    PMStepProfiler* stepProfiler = PMStepProfiler::Instance();
+    PMAllocCounter* allocCounter = PMAllocCounter::Instance();
+    PMScoringMesh* scoringMesh = PMScoringMesh::Instance();
+    PMMetrics* metrics = PMMetrics::Instance();
+    if (!IsMaster() || !G4Threading::IsMultithreadedApplication()) {
+        opticalResponse->MergeThreadMap();
+        stepProfiler->MergeThreadTable();
+        allocCounter->MergeThreadTotals();
+        scoringMesh->MergeThreadGrid();
+    }
+    if (IsMaster()) {
+        opticalResponse->EndOfRun();
+        stepProfiler->EndOfRun();
+        allocCounter->EndOfRun();
+        scoringMesh->EndOfRun(PMOutputManager::Instance()->GetBaseName(fEnergy));
+        metrics->EndOfRun();
+    }
+
+    if (IsMaster()) {
+        if (G4Threading::IsMultithreadedApplication()) {
+            fHistograms.MergeThreadSets();
+        }
+        WriteHistograms();
+    }
+
+    if (fEventWriter) {
+        fEventWriter->Close();
+    }
+    if (fPhotonWriter) {
+        fPhotonWriter->Close();
+    }
+
     G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
-    if (analysisManager->IsActive()) {
+    if (PMOutputManager::Instance()->IsRootEnabled() && analysisManager->IsOpenFile()) {
         analysisManager->Write();
         analysisManager->CloseFile();
     }
-    G4cout << "Run finished. Data saved in: simulation_output_" << fEnergy << "MeV.root" << G4endl;
+
+    if (!IsMaster()) {
+        return;
+    }
+
+    fTimer.Stop();
+    G4int nEvents = run->GetNumberOfEvent();
+    G4double seconds = fTimer.GetRealElapsed();
+
+    fLastRun.events = nEvents;
+    fLastRun.steps = fSteps.GetValue();
+    fLastRun.opticalPhotons = fOpticalPhotons.GetValue();
+    fLastRun.aluminumPhotons = fAluminumPhotons.GetValue();
+    fLastRun.aluminumWeight = fAluminumWeight.GetValue();
+    fLastRun.scintillationPhotons = fScintillationPhotons.GetValue();
+    fLastRun.gammasAtTeflon = fGammasAtTeflon.GetValue();
+    fLastRun.energyDeposit = fEnergyDeposit.GetValue();
+    fLastRun.seconds = seconds;
+    WriteCounters(run->GetRunID());
+
+    PM_SUMMARY("\n====== Run " << run->GetRunID() << " Summary ======\n"
+               << "🆔 Events: " << nEvents << "\n"
+               << "💡 Total Optical Photons: " << fOpticalPhotons.GetValue() << "\n"
+               << "🔹 Scintillation Photons: " << fScintillationPhotons.GetValue() << "\n"
+               << "🔹 Optical Photons Detected at Aluminum: " << fAluminumPhotons.GetValue()
+               << " (weighted: " << fAluminumWeight.GetValue() << ")\n"
+               << "🔹 Gammas at Teflon Barrier: " << fGammasAtTeflon.GetValue() << "\n"
+               << "🔎 Energy Deposited in NaI: " << fEnergyDeposit.GetValue() / MeV << " MeV"
+               << " (" << (nEvents > 0 ? fEnergyDeposit.GetValue() / MeV / nEvents : 0.)
+               << " MeV/event)\n"
+               << "👣 Steps: " << fSteps.GetValue() << "\n"
+               << "⏱ Wall time: " << seconds << " s ("
+               << (seconds > 0. ? nEvents / seconds : 0.) << " events/s)\n"
+               << "==========================================");
+    PM_SUMMARY("Run finished. Data saved in: " << PMOutputManager::Instance()->GetBaseName(fEnergy) << ".*");
+}
+
+void PMRunAction::WriteHistograms() {
+    PMOutputManager* output = PMOutputManager::Instance();
+    if (output->GetFormat() == "none") return;
+
+    G4String fileName = output->GetBaseName(fEnergy) + "_hist.txt";
+    if (!fHistograms.Write(fileName)) {
+        G4ExceptionDescription msg;
+        msg << "Could not write histograms to " << fileName;
+        G4Exception("PMRunAction::WriteHistograms", "PMRun001", JustWarning, msg);
+    }
+
+    // Workers never fill their H1s, so after the ntuple/histogram merge
+    // the master's copies hold exactly the merged set.
+    G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+    if (!output->IsRootEnabled() || !analysisManager->IsOpenFile()) return;
+    for (G4int h = 0; h < static_cast<G4int>(PMHistID::kCount); ++h) {
+        const PMHistID id = static_cast<PMHistID>(h);
+        const PMHistogramDef& def = PMHistogramSet::GetDef(id);
+        const G4double width = (def.max - def.min) / def.nBins;
+        for (G4int slot = 0; slot < def.nBins + 2; ++slot) {
+            G4double content = fHistograms.GetSlot(id, slot);
+            if (content != 0.) {
+                analysisManager->FillH1(h, def.min + (slot - 0.5) * width, content);
+            }
+        }
+    }
+}
+
+// Exact (%.17g) run totals next to the histograms, for tools/pm_reduce.
+void PMRunAction::WriteCounters(G4int runID) {
+    PMOutputManager* output = PMOutputManager::Instance();
+    if (output->GetFormat() == "none") return;
+
+    G4String fileName = output->GetBaseName(fEnergy) + "_counters.txt";
+    std::FILE* file = std::fopen(fileName.c_str(), "w");
+    if (file) {
+        const PMShard* shard = PMShard::Instance();
+        std::fprintf(file, "# PMRunCounters 1\n");
+        std::fprintf(file, "run %d\n", runID);
+        std::fprintf(file, "shard %d %d\n", shard->GetIndex(), shard->GetCount());
+        std::fprintf(file, "seed %ld\n", static_cast<long>(shard->GetMasterSeed()));
+        std::fprintf(file, "events %d\n", fLastRun.events);
+        std::fprintf(file, "steps %ld\n", static_cast<long>(fLastRun.steps));
+        std::fprintf(file, "opticalPhotons %ld\n", static_cast<long>(fLastRun.opticalPhotons));
+        std::fprintf(file, "aluminumPhotons %ld\n", static_cast<long>(fLastRun.aluminumPhotons));
+        std::fprintf(file, "scintillationPhotons %ld\n", static_cast<long>(fLastRun.scintillationPhotons));
+        std::fprintf(file, "gammasAtTeflon %ld\n", static_cast<long>(fLastRun.gammasAtTeflon));
+        std::fprintf(file, "aluminumWeight %.17e\n", fLastRun.aluminumWeight);
+        std::fprintf(file, "energyDeposit %.17e\n", fLastRun.energyDeposit / MeV);
+    }
+    if (!file || std::fclose(file) != 0) {
+        G4ExceptionDescription msg;
+        msg << "Could not write run counters to " << fileName;
+        G4Exception("PMRunAction::WriteCounters", "PMRun001", JustWarning, msg);
+    }
+}
+
+void PMRunAction::OpenColumnarWriters() {
+    PMOutputManager* output = PMOutputManager::Instance();
+
+    if (!fEventWriter) {
+        fEventWriter = new PMColumnarWriter();
+        fEventWriter->AddColumn("iEvent", PMColumnar::kInt32);
+        fEventWriter->AddColumn("nOptical", PMColumnar::kInt32);
+        fEventWriter->AddColumn("nGammaTeflon", PMColumnar::kInt32);
+        fEventWriter->AddColumn("nAluminum", PMColumnar::kInt32);
+        fEventWriter->AddColumn("nScintillation", PMColumnar::kInt32);
+        fEventWriter->AddColumn("Edep", PMColumnar::kFloat64);
+        fEventWriter->AddColumn("wAluminum", PMColumnar::kFloat64);
+        fEventWriter->AddColumn("digiCharge", PMColumnar::kFloat64);
+        fEventWriter->AddColumn("digiTime", PMColumnar::kFloat64);
+    }
+    fEventWriter->Open(output->GetThreadFileName(fEnergy, "_events.pmc"),
+                       output->GetChunkRows(), output->GetCompress());
+
+    if (!output->IsPhotonRecordingEnabled()) {
+        return;
+    }
+    if (!fPhotonWriter) {
+        fPhotonWriter = new PMColumnarWriter();
+        fPhotonWriter->AddColumn("iEvent", PMColumnar::kInt32);
+        fPhotonWriter->AddColumn("fX", PMColumnar::kFloat64);
+        fPhotonWriter->AddColumn("fY", PMColumnar::kFloat64);
+        fPhotonWriter->AddColumn("fZ", PMColumnar::kFloat64);
+        fPhotonWriter->AddColumn("fGlobalTime", PMColumnar::kFloat64);
+        fPhotonWriter->AddColumn("fWlen", PMColumnar::kFloat64);
+        fPhotonWriter->AddColumn("nBounces", PMColumnar::kInt32);
+        fPhotonWriter->AddColumn("fX0", PMColumnar::kFloat64);
+        fPhotonWriter->AddColumn("fY0", PMColumnar::kFloat64);
+        fPhotonWriter->AddColumn("fZ0", PMColumnar::kFloat64);
+        fPhotonWriter->AddColumn("fWeight", PMColumnar::kFloat64);
+    }
+    fPhotonWriter->Open(output->GetThreadFileName(fEnergy, "_photons.pmc"),
+                        output->GetChunkRows() * 16, output->GetCompress());
+}
+
+void PMRunAction::AddEvent(G4int opticalPhotons, G4int aluminumPhotons,
+                           G4int scintillationPhotons, G4int gammasAtTeflon, G4double edep,
+                           G4long steps, G4double aluminumWeight) {
+    fOpticalPhotons += opticalPhotons;
+    fAluminumPhotons += aluminumPhotons;
+    fScintillationPhotons += scintillationPhotons;
+    fGammasAtTeflon += gammasAtTeflon;
+    fEnergyDeposit += edep;
+    fSteps += steps;
+    fAluminumWeight += aluminumWeight;
 }
@@ -0,0 +1,165 @@
+#include "PMScoringMesh.hh"
+#include "PMScoringMeshMessenger.hh"
+#include "PMLog.hh"
+#include "G4AutoLock.hh"
+#include "G4Exception.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+// <stem>_mesh.pmm, little-endian as written by the host:
+//   char     magic[8]         "PMMESH01"
+//   int32    nx, ny, nz       voxels per axis
+//   int32    blockSize        8 (voxels per block edge)
+//   int32    nQuantities      2 (edep in MeV, photon origins as summed weight)
+//   int32    nBlocks          blocks that follow
+//   float64  pitch, hx, hy, hz   mm; voxel (0,0,0) starts at (-hx, -hy, -hz)
+//   nBlocks x { int32 block; float64 values[nQuantities][512] }
+// Block b covers voxels from 8 * (b % bx, b / bx % by, b / (bx * by)) with
+// bx = ceil(nx / 8), by = ceil(ny / 8); inside a block x runs fastest.
+// Voxels past nx, ny, nz in edge blocks are always zero.
+namespace {
+const char kMagic[8] = {'P', 'M', 'M', 'E', 'S', 'H', '0', '1'};
+
+// Owns the thread's grid; fThreadGrid points to it only while scoring.
+G4ThreadLocal PMScoringGrid* threadStorage = nullptr;
+}
+
+G4ThreadLocal PMScoringGrid* PMScoringMesh::fThreadGrid = nullptr;
+
+PMScoringGrid::PMScoringGrid()
+    : fPitch(0.), fInversePitch(0.), fNx(0), fNy(0), fNz(0), fBx(0), fBy(0), fBz(0) {}
+
+void PMScoringGrid::Configure(const G4ThreeVector& halfSize, G4double pitch) {
+    const G4int nx = std::max(1, static_cast<G4int>(std::ceil(2. * halfSize.x() / pitch - 1e-9)));
+    const G4int ny = std::max(1, static_cast<G4int>(std::ceil(2. * halfSize.y() / pitch - 1e-9)));
+    const G4int nz = std::max(1, static_cast<G4int>(std::ceil(2. * halfSize.z() / pitch - 1e-9)));
+    if (nx == fNx && ny == fNy && nz == fNz && pitch == fPitch && halfSize == fHalfSize) {
+        Clear();
+        return;
+    }
+    fHalfSize = halfSize;
+    fPitch = pitch;
+    fInversePitch = 1. / pitch;
+    fNx = nx;
+    fNy = ny;
+    fNz = nz;
+    fBx = (nx + kBlockSize - 1) / kBlockSize;
+    fBy = (ny + kBlockSize - 1) / kBlockSize;
+    fBz = (nz + kBlockSize - 1) / kBlockSize;
+    fBlocks.clear();
+    fBlocks.resize(static_cast<std::size_t>(fBx) * fBy * fBz);
+}
+
+void PMScoringGrid::Clear() {
+    for (std::unique_ptr<Block>& block : fBlocks) {
+        if (block) {
+            std::memset(block->values, 0, sizeof(block->values));
+        }
+    }
+}
+
+PMScoringGrid::Block* PMScoringGrid::GetOrCreateBlock(G4int index) {
+    std::unique_ptr<Block>& block = fBlocks[index];
+    if (!block) {
+        block.reset(new Block());
+    }
+    return block.get();
+}
+
+G4int PMScoringGrid::GetAllocatedBlocks() const {
+    return static_cast<G4int>(std::count_if(fBlocks.begin(), fBlocks.end(),
+                                            [](const std::unique_ptr<Block>& block) { return block != nullptr; }));
+}
+
+G4bool PMScoringGrid::Save(const G4String& fileName) const {
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    const int32_t header[6] = {fNx, fNy, fNz, kBlockSize, kQuantities, GetAllocatedBlocks()};
+    const G4double geometry[4] = {fPitch / mm, fHalfSize.x() / mm, fHalfSize.y() / mm, fHalfSize.z() / mm};
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(geometry), sizeof(geometry));
+    for (std::size_t i = 0; i < fBlocks.size(); ++i) {
+        if (!fBlocks[i]) {
+            continue;
+        }
+        const int32_t index = static_cast<int32_t>(i);
+        out.write(reinterpret_cast<const char*>(&index), sizeof(index));
+        out.write(reinterpret_cast<const char*>(fBlocks[i]->values), sizeof(fBlocks[i]->values));
+    }
+    return static_cast<G4bool>(out);
+}
+
+PMScoringMesh* PMScoringMesh::Instance() {
+    static PMScoringMesh* instance = new PMScoringMesh();
+    return instance;
+}
+
+PMScoringMesh::PMScoringMesh()
+    : fEnabled(false),
+      fPitch(1. * mm),
+      fCrystalHalfSize(5. * cm, 5. * cm, 1.5 * cm),
+      fMessenger(new PMScoringMeshMessenger(this)) {}
+
+void PMScoringMesh::BeginOfRun() {
+    if (fEnabled) {
+        fMerged.Configure(fCrystalHalfSize, fPitch);
+    }
+}
+
+void PMScoringMesh::BeginOfThreadRun() {
+    if (!fEnabled) {
+        fThreadGrid = nullptr;
+        return;
+    }
+    if (!threadStorage) {
+        threadStorage = new PMScoringGrid();
+    }
+    threadStorage->Configure(fCrystalHalfSize, fPitch);
+    fThreadGrid = threadStorage;
+}
+
+void PMScoringMesh::MergeThreadGrid() {
+    if (!fThreadGrid) {
+        return;
+    }
+    const PMScoringGrid& grid = *fThreadGrid;
+    for (G4int i = 0; i < grid.GetBlockCount(); ++i) {
+        const PMScoringGrid::Block* block = grid.GetBlock(i);
+        if (!block) {
+            continue;
+        }
+        G4AutoLock lock(&fStripes[i % kStripes]);
+        PMScoringGrid::Block* merged = fMerged.GetOrCreateBlock(i);
+        for (G4int q = 0; q < PMScoringGrid::kQuantities; ++q) {
+            for (G4int v = 0; v < PMScoringGrid::kBlockVoxels; ++v) {
+                merged->values[q][v] += block->values[q][v];
+            }
+        }
+    }
+    fThreadGrid = nullptr;
+}
+
+void PMScoringMesh::EndOfRun(const G4String& stem) {
+    if (!fEnabled) {
+        return;
+    }
+    const G4String fileName = stem + "_mesh.pmm";
+    if (!fMerged.Save(fileName)) {
+        G4ExceptionDescription msg;
+        msg << "Cannot write scoring mesh " << fileName;
+        G4Exception("PMScoringMesh::EndOfRun", "PMOutput003", JustWarning, msg);
+        return;
+    }
+    const G4int blocks = fMerged.GetAllocatedBlocks();
+    PM_SUMMARY("✔ Scoring mesh written to " << fileName << ": " << fMerged.GetNx() << " x "
+               << fMerged.GetNy() << " x " << fMerged.GetNz() << " voxels of " << fPitch / mm << " mm, "
+               << blocks << " of " << fMerged.GetBlockCount() << " blocks ("
+               << blocks * sizeof(PMScoringGrid::Block) / 1024 << " kB)");
+}
@@ -0,0 +1,49 @@
+#include "PMScoringMeshMessenger.hh"
+#include "PMScoringMesh.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+PMScoringMeshMessenger::PMScoringMeshMessenger(PMScoringMesh* mesh) : fMesh(mesh) {
+    fDirectory = new G4UIdirectory("/PM/mesh/");
+    fDirectory->SetGuidance("Energy deposit and photon origin maps over the crystal.");
+
+    fEnableCmd = new G4UIcmdWithABool("/PM/mesh/enable", this);
+    fEnableCmd->SetGuidance("Score into the mesh from the next run on; written as <stem>_mesh.pmm.");
+    fEnableCmd->SetParameterName("enabled", true);
+    fEnableCmd->SetDefaultValue(true);
+    fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEnableCmd->SetToBeBroadcasted(false);
+
+    fPitchCmd = new G4UIcmdWithADoubleAndUnit("/PM/mesh/pitch", this);
+    fPitchCmd->SetGuidance("Voxel edge length (cubic voxels).");
+    fPitchCmd->SetParameterName("pitch", false);
+    fPitchCmd->SetRange("pitch > 0.");
+    fPitchCmd->SetDefaultUnit("mm");
+    fPitchCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fPitchCmd->SetToBeBroadcasted(false);
+}
+
+PMScoringMeshMessenger::~PMScoringMeshMessenger() {
+    delete fPitchCmd;
+    delete fEnableCmd;
+    delete fDirectory;
+}
+
+void PMScoringMeshMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fEnableCmd) {
+        fMesh->SetEnabled(G4UIcmdWithABool::GetNewBoolValue(newValue));
+    } else if (command == fPitchCmd) {
+        fMesh->SetPitch(G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+    }
+}
+
+G4String PMScoringMeshMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fEnableCmd) {
+        return G4UIcommand::ConvertToString(fMesh->IsEnabled());
+    }
+    if (command == fPitchCmd) {
+        return fPitchCmd->ConvertToString(fMesh->GetPitch(), "mm");
+    }
+    return "";
+}
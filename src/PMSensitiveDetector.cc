@@ -1,83 +1,213 @@
 #include "PMSensitiveDetector.hh"
 #include "G4Step.hh"
 #include "G4Track.hh"
-#include "PMEventAction.hh"
 #include "G4ParticleDefinition.hh"
-#include "PMDetectorConstruction.hh"
+#include "PMVolumeRegistry.hh"
+#include "PMOpticalResponse.hh"
+#include "PMFastScintillatorModel.hh"
+#include "PMEmissionSpectrum.hh"
+#include "PMScoringMesh.hh"
+#include "PMAllocCounter.hh"
+#include "G4FastHit.hh"
+#include "G4FastTrack.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "Randomize.hh"
+#include "G4Poisson.hh"
 #include "G4OpticalPhoton.hh"
-#include "G4RunManager.hh"
+#include "G4OpBoundaryProcess.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
 #include "G4EventManager.hh"
 #include "G4Event.hh"
-#include "G4AnalysisManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "PMLog.hh"
+
+#include <algorithm>
+#include <cmath>
 
 PMSensitiveDetector::PMSensitiveDetector(const G4String& name)
     : G4VSensitiveDetector(name),
+      fEdepHits(nullptr),
+      fPhotonHits(nullptr),
+      fEdepCollectionID(-1),
+      fPhotonCollectionID(-1),
+      fLastEdepHits(0),
+      fLastPhotonHits(0),
       fTotalOpticalPhotons(0),
       fPhotonsAtScintillator(0),
-      fPhotonsAtAluminum(0) {}   
+      fYieldMaterial(nullptr),
+      fYield(0.),
+      fResolutionScale(1.),
+      fDecayTime(0.),
+      fSpectrum(nullptr) {
+    collectionName.insert("edep");
+    collectionName.insert("photons");
+}
 
 PMSensitiveDetector::~PMSensitiveDetector() {}
 
-void PMSensitiveDetector::Initialize(G4HCofThisEvent*) {
+void PMSensitiveDetector::Initialize(G4HCofThisEvent* hce) {
+    PM_ALLOC_SCOPE(kSensitive);
+    // The kernel deletes the collections with the event. Reserving the
+    // previous event's size turns their growth into one allocation each.
+    fEdepHits = new PMHitsCollection(SensitiveDetectorName, collectionName[0]);
+    fPhotonHits = new PMHitsCollection(SensitiveDetectorName, collectionName[1]);
+    fEdepHits->GetVector()->reserve(fLastEdepHits);
+    fPhotonHits->GetVector()->reserve(fLastPhotonHits);
+    if (fEdepCollectionID < 0) {
+        fEdepCollectionID = G4SDManager::GetSDMpointer()->GetCollectionID(fEdepHits);
+        fPhotonCollectionID = G4SDManager::GetSDMpointer()->GetCollectionID(fPhotonHits);
+    }
+    hce->AddHitsCollection(fEdepCollectionID, fEdepHits);
+    hce->AddHitsCollection(fPhotonCollectionID, fPhotonHits);
+
+    // assign() keeps the capacity, so this only allocates after the array
+    // has grown.
+    fModuleEdepHit.assign(PMVolumeRegistry::Instance()->GetModuleCount(), -1);
     fTotalOpticalPhotons = 0;
     fPhotonsAtScintillator = 0;
-    fPhotonsAtAluminum = 0;
+}
+
+G4bool PMSensitiveDetector::IsDetection(const G4Step* step) {
+    const PMVolumeRegistry* registry = PMVolumeRegistry::Instance();
+    const G4StepPoint* postStep = step->GetPostStepPoint();
+    if (registry->Classify(step->GetPreStepPoint()->GetPhysicalVolume()) == PMVolumeID::kAluminum) {
+        return true;
+    }
+    if (postStep->GetStepStatus() == fGeomBoundary &&
+        registry->Classify(postStep->GetPhysicalVolume()) == PMVolumeID::kAluminum) {
+        return true;
+    }
+    const G4OpBoundaryProcess* boundary = PMVolumeRegistry::GetBoundaryProcess();
+    return boundary && postStep->GetProcessDefinedStep() == boundary && boundary->GetStatus() == Detection;
 }
 
 G4bool PMSensitiveDetector::ProcessHits(G4Step* step, G4TouchableHistory*) {
+    PM_ALLOC_SCOPE(kSensitive);
     G4Track* track = step->GetTrack();
+    const G4StepPoint* preStep = step->GetPreStepPoint();
+    const G4int module = PMVolumeRegistry::ModuleCopyNumber(preStep->GetTouchable());
 
-    G4int eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
-    G4int trackID = track->GetTrackID();
-    G4String particleName = track->GetDefinition()->GetParticleName();
-    G4double kineticEnergy = step->GetPreStepPoint()->GetKineticEnergy();
-    G4ThreeVector position = step->GetPreStepPoint()->GetPosition();
-    G4double energyDeposited = step->GetTotalEnergyDeposit();
-    G4String volName = step->GetPreStepPoint()->GetPhysicalVolume()->GetName();
-    
-    if (particleName != "opticalphoton") {
-        G4cout << "🔍 Non-optical Particle = " << particleName << G4endl;
+    if (track->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition()) {
+        PM_TRACE("🔍 Non-optical Particle = " << track->GetDefinition()->GetParticleName());
+        const G4double edep = step->GetTotalEnergyDeposit();
+        if (edep <= 0. ||
+            PMVolumeRegistry::Instance()->Classify(preStep->GetPhysicalVolume()) != PMVolumeID::kScintillator) {
+            return false;
+        }
+        AddEnergy(module, edep, preStep->GetGlobalTime());
+        return true;
     }
 
-    if (track->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition()) {
+    if (track->GetCurrentStepNumber() == 1) {
         fTotalOpticalPhotons++;
-
-        G4String volName = step->GetPreStepPoint()->GetPhysicalVolume()->GetName();
-
-        if (volName == "ScintillatorPhys") {
+        if (PMVolumeRegistry::Instance()->Classify(preStep->GetPhysicalVolume()) == PMVolumeID::kScintillator) {
             fPhotonsAtScintillator++;
         }
+    }
 
-        if (volName == "AluminumPlate" || volName == "AluminumSurface" || volName == "AluminumPhys") {
-            fPhotonsAtAluminum++;
-            G4cout << "⚡ Optical Photon Detected at Aluminum (SensitiveDetector)! Count: " 
-                   << fPhotonsAtAluminum << G4endl;
+    if (!IsDetection(step)) {
+        return false;
+    }
+    fPhotonHits->insert(new PMHit(module, track->GetTotalEnergy(),
+                                  step->GetPostStepPoint()->GetGlobalTime(), track->GetWeight()));
+    PM_TRACE("⚡ Optical Photon Detected at Aluminum (SensitiveDetector)! Count: "
+             << fPhotonHits->entries());
+    return true;
+}
 
-            PMEventAction* eventAction = static_cast<PMEventAction*>(
-                G4EventManager::GetEventManager()->GetUserEventAction());
-            if (eventAction) {
-                eventAction->AddAluminumPhoton();
-            }
-        }
+void PMSensitiveDetector::AddEnergy(G4int module, G4double energy, G4double time) {
+    if (module < 0 || module >= static_cast<G4int>(fModuleEdepHit.size())) {
+        fEdepHits->insert(new PMHit(module, energy, time));
+    } else if (fModuleEdepHit[module] < 0) {
+        fModuleEdepHit[module] = static_cast<G4int>(fEdepHits->entries());
+        fEdepHits->insert(new PMHit(module, energy, time));
+    } else {
+        (*fEdepHits)[fModuleEdepHit[module]]->AddEnergy(energy);
+    }
+}
+
+G4bool PMSensitiveDetector::ProcessHits(const G4FastHit* hit, const G4FastTrack* track,
+                                        G4TouchableHistory* touchable) {
+    PM_ALLOC_SCOPE(kSensitive);
+    const G4VPhysicalVolume* volume = touchable->GetVolume();
+    if (PMVolumeRegistry::Instance()->Classify(volume) != PMVolumeID::kScintillator) {
+        return false;
+    }
+    const G4int module = PMVolumeRegistry::ModuleCopyNumber(touchable);
+    const G4double time = track->GetPrimaryTrack()->GetGlobalTime();
+    AddEnergy(module, hit->GetEnergy(), time);
+
+    const G4ThreeVector local = PMVolumeRegistry::ToModuleFrame(touchable, hit->GetPosition());
+    if (PMScoringGrid* mesh = PMScoringMesh::GetThreadGrid()) {
+        mesh->Add(PMScoringGrid::kEdep, local, hit->GetEnergy());
+    }
+    const G4int detected = SampleDetectedPhotons(volume->GetLogicalVolume()->GetMaterial(), hit->GetEnergy(),
+                                                 local);
+    // Energy from the tabulated emission spectrum and emission delay from
+    // the crystal's decay time, as tracked photons would carry them.
+    for (G4int i = 0; i < detected; ++i) {
+        const G4double photonEnergy = fSpectrum ? fSpectrum->Sample(G4UniformRand()) : 2.99 * eV;
+        const G4double delay = fDecayTime > 0. ? G4RandExponential::shoot(fDecayTime) : 0.;
+        fPhotonHits->insert(new PMHit(module, photonEnergy, time + delay));
     }
     return true;
 }
 
+G4int PMSensitiveDetector::SampleDetectedPhotons(const G4Material* material, G4double energy,
+                                                 const G4ThreeVector& position) {
+    if (material != fYieldMaterial) {
+        fYieldMaterial = material;
+        const G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+        fYield = (mpt && mpt->ConstPropertyExists("SCINTILLATIONYIELD"))
+                     ? mpt->GetConstProperty("SCINTILLATIONYIELD") : 0.;
+        fResolutionScale = (mpt && mpt->ConstPropertyExists("RESOLUTIONSCALE"))
+                               ? mpt->GetConstProperty("RESOLUTIONSCALE") : 1.;
+        fDecayTime = (mpt && mpt->ConstPropertyExists("SCINTILLATIONTIMECONSTANT1"))
+                         ? mpt->GetConstProperty("SCINTILLATIONTIMECONSTANT1") : 0.;
+        fSpectrum = PMEmissionSpectrum::Find(material);
+    }
+
+    const G4double mean = fYield * energy;
+    G4int emitted = 0;
+    if (mean > 10.) {
+        emitted = std::max(0, static_cast<G4int>(G4RandGauss::shoot(mean, fResolutionScale * std::sqrt(mean)) + 0.5));
+    } else if (mean > 0.) {
+        emitted = static_cast<G4int>(G4Poisson(mean));
+    }
+    if (emitted == 0) {
+        return 0;
+    }
+
+    const PMOpticalResponse* response = PMOpticalResponse::Instance();
+    G4double efficiency = PMFastSimConfig::Instance()->GetLightCollection();
+    if (response->GetMode() == PMOpticalResponse::kFast) {
+        const PMLightCollectionMap& map = response->GetMap();
+        efficiency = map.Efficiency(map.Index(position, fSpectrum ? fSpectrum->GetMeanEnergy() : 2.99 * eV));
+    }
+    return static_cast<G4int>(CLHEP::RandBinomial::shoot(emitted, efficiency));
+}
+
 void PMSensitiveDetector::EndOfEvent(G4HCofThisEvent*) {
-    G4int eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
-
-    G4cout << "\n======= Event Summary =======" << G4endl;
-    G4cout << "🆔 Event ID: " << eventID << G4endl;
-    G4cout << "🔹 Total Optical Photons Created: " << fTotalOpticalPhotons << G4endl;
-    G4cout << "🔹 Optical Photons Created in Scintillator: " << fPhotonsAtScintillator << G4endl;
-    G4cout << "🔹 Optical Photons Detected at Aluminum: " << fPhotonsAtAluminum << G4endl;
-    G4cout << "=====================================\n" << G4endl;
-
-    G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
-    if (analysisManager) {
-        analysisManager->FillH1(0, fTotalOpticalPhotons);
-        analysisManager->FillH1(1, fPhotonsAtScintillator);
-        analysisManager->FillH1(2, fPhotonsAtAluminum);
+    fLastEdepHits = fEdepHits->entries();
+    fLastPhotonHits = fPhotonHits->entries();
+
+    PM_DEBUG("\n======= Event Summary =======\n"
+             << "🆔 Event ID: "
+             << G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID() << "\n"
+             << "🔹 Total Optical Photons Created: " << fTotalOpticalPhotons << "\n"
+             << "🔹 Optical Photons Created in Scintillator: " << fPhotonsAtScintillator << "\n"
+             << "🔹 Optical Photons Detected at Aluminum: " << fPhotonHits->entries() << "\n"
+             << "=====================================\n");
+
+#if PM_LOG_MAX_LEVEL >= 2
+    if (PM_DEBUG_ENABLED() && fModuleEdepHit.size() > 1) {
+        for (std::size_t i = 0; i < fEdepHits->entries(); ++i) {
+            const PMHit* hit = (*fEdepHits)[i];
+            G4cout << "   module " << hit->GetModule() << ": " << hit->GetEnergy() / MeV << " MeV"
+                   << G4endl;
+        }
     }
+#endif
 }
@@ -0,0 +1,75 @@
+#include "PMSetup.hh"
+#include "PMActionInitialization.hh"
+#include "PMCommandLine.hh"
+#include "PMDetectorConstruction.hh"
+#include "PMDigitizer.hh"
+#include "PMFastScintillatorModel.hh"
+#include "PMLog.hh"
+#include "PMMetrics.hh"
+#include "PMOpticalResponse.hh"
+#include "PMOutputManager.hh"
+#include "PMPhysicsList.hh"
+#include "PMScoringMesh.hh"
+#include "PMShard.hh"
+#include "PMStackingAction.hh"
+#include "PMStartupProfiler.hh"
+#include "PMStepProfiler.hh"
+#include "G4RunManagerFactory.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "Randomize.hh"
+
+G4RunManager* PMSetup::CreateRunManager(const PMCommandLine& options) {
+    G4RunManager* runManager = CreateRunManager(options.nThreads);
+    InitSingletons();
+    ConfigureShard(options.shardIndex, options.shardCount, options.seed);
+    if (G4Threading::IsMultithreadedApplication()) {
+        PM_SUMMARY("✔ Running with " << runManager->GetNumberOfThreads() << " worker threads");
+    }
+    SetUserInitializations(runManager, options.physics, options.tableCache, 5 * MeV);
+    return runManager;
+}
+
+G4RunManager* PMSetup::CreateRunManager(G4int nThreads) {
+    G4RunManager* runManager = nullptr;
+    {
+        PMStartupScope profile("run manager");
+        runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::Default);
+    }
+    runManager->SetNumberOfThreads(nThreads);
+    return runManager;
+}
+
+void PMSetup::InitSingletons() {
+    PMLog::Instance();
+    PMOpticalResponse::Instance();
+    PMOutputManager::Instance();
+    PMStepProfiler::Instance();
+    PMDigitizerConfig::Instance();
+    PMFastSimConfig::Instance();
+    PMStackingConfig::Instance();
+    PMScoringMesh::Instance();
+    PMMetrics::Instance();
+}
+
+void PMSetup::ConfigureShard(G4int index, G4int count, G4long seed) {
+    PMShard* shard = PMShard::Instance();
+    shard->Configure(index, count);
+    if (seed != 0) {
+        G4Random::setTheSeed(seed);
+        shard->SetMasterSeed(seed);
+    }
+    if (shard->IsSharded()) {
+        PM_SUMMARY("✔ Shard " << shard->GetIndex() << " of " << shard->GetCount()
+                   << ", master seed " << shard->GetMasterSeed());
+    }
+}
+
+void PMSetup::SetUserInitializations(G4RunManager* runManager, const G4String& physics,
+                                     const G4String& tableCache, G4double energy) {
+    runManager->SetUserInitialization(new PMDetectorConstruction());
+    auto* physicsList = new PMPhysicsList(physics);
+    physicsList->SetTableCacheDirectory(tableCache);
+    runManager->SetUserInitialization(physicsList);
+    runManager->SetUserInitialization(new PMActionInitialization(energy));
+}
@@ -0,0 +1,78 @@
+#include "PMShard.hh"
+#include "G4Exception.hh"
+#include "Randomize.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+
+namespace {
+std::uint64_t SplitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Engine seeds must be positive and fit a 32-bit long.
+long EngineSeed(std::uint64_t& state) {
+    return static_cast<long>(SplitMix64(state) >> 34) + 1;
+}
+}
+
+PMShard::PMShard()
+    : fIndex(0),
+      fCount(1),
+      fEventsPerShard(0),
+      fMasterSeed(0),
+      fSeeding(false) {}
+
+PMShard* PMShard::Instance() {
+    static PMShard* instance = new PMShard();
+    return instance;
+}
+
+void PMShard::Configure(G4int index, G4int count) {
+    fIndex = index;
+    fCount = count;
+    fSeeding = fSeeding || IsSharded();
+}
+
+void PMShard::SetMasterSeed(G4long seed) {
+    fMasterSeed = seed;
+    fSeeding = true;
+}
+
+void PMShard::BeginOfRun(G4int eventsInRun) {
+    fEventsPerShard = eventsInRun;
+    const G4long globalEvents = static_cast<G4long>(fCount) * eventsInRun;
+    if (globalEvents > static_cast<G4long>(std::numeric_limits<G4int>::max()) + 1) {
+        G4ExceptionDescription msg;
+        msg << fCount << " shards x " << eventsInRun << " events = " << globalEvents
+            << " global events; the event ID columns of the output hold at most "
+            << std::numeric_limits<G4int>::max() << ".";
+        G4Exception("PMShard::BeginOfRun", "PMRun002", FatalException, msg);
+    }
+}
+
+void PMShard::SeedEvent(G4int runID, G4int eventID) const {
+    std::uint64_t state = static_cast<std::uint64_t>(fMasterSeed);
+    state = SplitMix64(state) ^ (static_cast<std::uint64_t>(runID) << 40)
+            ^ static_cast<std::uint64_t>(GetGlobalEventID(eventID));
+    long seeds[3] = {EngineSeed(state), EngineSeed(state), 0};
+    G4Random::setTheSeeds(seeds, -1);
+}
+
+G4String PMShard::GetFileSuffix() const {
+    if (!IsSharded()) return "";
+    std::ostringstream suffix;
+    suffix << "_shard" << fIndex;
+    return suffix.str();
+}
+
+G4bool PMShard::Parse(const char* text, G4int& index, G4int& count) {
+    char tail = 0;
+    if (std::sscanf(text, "%d/%d%c", &index, &count, &tail) != 2) return false;
+    return count > 0 && index >= 0 && index < count;
+}
@@ -0,0 +1,222 @@
+#include "PMStackingAction.hh"
+#include "PMStackingMessenger.hh"
+#include "PMEventAction.hh"
+#include "PMOpticalResponse.hh"
+#include "PMVolumeRegistry.hh"
+#include "PMEmissionSpectrum.hh"
+#include "PMScoringMesh.hh"
+#include "PMAllocCounter.hh"
+#include "G4Track.hh"
+#include "G4Step.hh"
+#include "G4DynamicParticle.hh"
+#include "G4VProcess.hh"
+#include "G4ProcessTable.hh"
+#include "G4Scintillation.hh"
+#include "G4Electron.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4OpProcessSubType.hh"
+#include "G4EventManager.hh"
+#include "G4StackManager.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+PMStackingConfig* PMStackingConfig::Instance() {
+    static PMStackingConfig* instance = new PMStackingConfig();
+    return instance;
+}
+
+PMStackingConfig::PMStackingConfig()
+    : fLazyScintillation(false),
+      fBatchSize(10000),
+      fMessenger(new PMStackingMessenger(this)) {}
+
+PMStackingAction::PMStackingAction(PMEventAction* eventAction)
+    : G4UserStackingAction(),
+      fEventAction(eventAction),
+      fResponse(PMOpticalResponse::Instance()),
+      fOpticalPhoton(G4OpticalPhoton::Definition()),
+      fScintillationProcess(nullptr),
+      fProcessLookedUp(false),
+      fLazy(false),
+      fRecordMaterial(nullptr),
+      fRecordSpectrum(nullptr),
+      fRecordDecayTime(0.) {}
+
+PMStackingAction::~PMStackingAction() {}
+
+G4ClassificationOfNewTrack PMStackingAction::ClassifyNewTrack(const G4Track* track) {
+    PM_ALLOC_SCOPE(kStacking);
+    if (track->GetDefinition() != fOpticalPhoton || track->GetParentID() == 0) {
+        return fUrgent;
+    }
+
+    // Every new photon is counted here, whether it is tracked, killed by
+    // the fast/off modes or dropped by downsampling.
+    fEventAction->AddOpticalPhoton();
+    const G4VProcess* creator = track->GetCreatorProcess();
+    if (creator && creator->GetProcessSubType() == fScintillation) {
+        fEventAction->AddScintillationPhoton();
+    }
+    if (PMScoringGrid* mesh = PMScoringMesh::GetThreadGrid()) {
+        mesh->Add(PMScoringGrid::kPhotonOrigins, CrystalPosition(track), track->GetWeight());
+    }
+
+    switch (fResponse->GetMode()) {
+        case PMOpticalResponse::kOff:
+            return fKill;
+        case PMOpticalResponse::kFast: {
+            const PMLightCollectionMap& map = fResponse->GetMap();
+            G4int cell = map.Index(CrystalPosition(track), track->GetKineticEnergy());
+            if (G4UniformRand() < map.Efficiency(cell)) {
+                fEventAction->AddAluminumPhoton(track->GetWeight());
+            }
+            return fKill;
+        }
+        case PMOpticalResponse::kCalibrate: {
+            // All photons count as emitted; the detected side is weighted.
+            PMLightCollectionMap* map = fResponse->GetThreadMap();
+            map->AddEmitted(map->Index(CrystalPosition(track), track->GetKineticEnergy()), track->GetWeight());
+            return Downsample(track);
+        }
+        default:
+            return Downsample(track);
+    }
+}
+
+// New photons carry the touchable of the step that created them.
+G4ThreeVector PMStackingAction::CrystalPosition(const G4Track* track) {
+    return PMVolumeRegistry::ToModuleFrame(track->GetTouchable(), track->GetPosition());
+}
+
+G4ClassificationOfNewTrack PMStackingAction::Downsample(const G4Track* track) const {
+    const G4double keep = fResponse->GetKeepFraction();
+    if (keep >= 1.) {
+        return fUrgent;
+    }
+    if (G4UniformRand() >= keep) {
+        return fKill;
+    }
+    // Not yet stacked, so nothing else has seen the old weight.
+    const_cast<G4Track*>(track)->SetWeight(track->GetWeight() / keep);
+    return fUrgent;
+}
+
+void PMStackingAction::PrepareNewEvent() {
+    PM_ALLOC_SCOPE(kStacking);
+    if (!fProcessLookedUp) {
+        fProcessLookedUp = true;
+        fScintillationProcess = dynamic_cast<G4Scintillation*>(
+            G4ProcessTable::GetProcessTable()->FindProcess("Scintillation", G4Electron::Definition()));
+    }
+    fPending.clear();
+
+    fLazy = fScintillationProcess && PMStackingConfig::Instance()->IsLazyScintillation();
+    if (fScintillationProcess) {
+        // Set every event: a physics-table rebuild re-reads StackPhotons
+        // from G4OpticalParameters. The process still samples the photon count
+        // of every step (GetNumPhotons); it just stops creating the tracks.
+        fScintillationProcess->SetStackPhotons(!fLazy);
+    }
+}
+
+void PMStackingAction::RecordEmission(const G4Step* step) {
+    const G4int photons = fScintillationProcess->GetNumPhotons();
+    if (photons <= 0) {
+        return;
+    }
+
+    const G4StepPoint* preStep = step->GetPreStepPoint();
+    const G4Material* material = preStep->GetMaterial();
+    if (material != fRecordMaterial) {
+        fRecordMaterial = material;
+        fRecordSpectrum = PMEmissionSpectrum::Find(material);
+        const G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+        fRecordDecayTime = (mpt && mpt->ConstPropertyExists("SCINTILLATIONTIMECONSTANT1"))
+                               ? mpt->GetConstProperty("SCINTILLATIONTIMECONSTANT1") : 0.;
+        if (!fRecordSpectrum) {
+            G4ExceptionDescription msg;
+            msg << "No emission spectrum for " << material->GetName()
+                << "; its scintillation photons are dropped with /PM/stack/lazyScintillation";
+            G4Exception("PMStackingAction::RecordEmission", "PMOptical003", JustWarning, msg);
+        }
+    }
+    if (!fRecordSpectrum) {
+        return;
+    }
+
+    const G4StepPoint* postStep = step->GetPostStepPoint();
+    EmissionRecord record;
+    record.start = preStep->GetPosition();
+    record.delta = postStep->GetPosition() - record.start;
+    record.time = preStep->GetGlobalTime();
+    record.duration = postStep->GetGlobalTime() - record.time;
+    record.weight = step->GetTrack()->GetWeight();
+    record.decayTime = fRecordDecayTime;
+    record.spectrum = fRecordSpectrum;
+    record.touchable = preStep->GetTouchableHandle();
+    record.parentID = step->GetTrack()->GetTrackID();
+    record.remaining = photons;
+    fPending.push_back(record);
+}
+
+// Called whenever the urgent stack runs empty. Batches go through
+// ClassifyNewTrack like any other photon, so a batch that is killed
+// entirely (off/fast modes, downsampling) is followed by the next one.
+void PMStackingAction::NewStage() {
+    PM_ALLOC_SCOPE(kStacking);
+    const std::size_t batchSize = PMStackingConfig::Instance()->GetBatchSize();
+    while (!fPending.empty() && stackManager->GetNUrgentTrack() == 0) {
+        while (!fPending.empty() && fBatch.size() < batchSize) {
+            EmissionRecord& record = fPending.back();
+            const G4int n = static_cast<G4int>(std::min<std::size_t>(record.remaining, batchSize - fBatch.size()));
+            for (G4int i = 0; i < n; ++i) {
+                fBatch.push_back(MakePhoton(record));
+            }
+            record.remaining -= n;
+            if (record.remaining == 0) {
+                fPending.pop_back();
+            }
+        }
+        // Assigns track IDs and clears the vector.
+        G4EventManager::GetEventManager()->StackTracks(&fBatch);
+        fBatch.clear();
+    }
+}
+
+// Same sampling as G4Scintillation::PostStepDoIt for a single component.
+G4Track* PMStackingAction::MakePhoton(const EmissionRecord& record) const {
+    const G4double cost = 1. - 2. * G4UniformRand();
+    const G4double sint = std::sqrt((1. - cost) * (1. + cost));
+    G4double phi = twopi * G4UniformRand();
+    G4double sinp = std::sin(phi);
+    G4double cosp = std::cos(phi);
+    const G4ThreeVector direction(sint * cosp, sint * sinp, cost);
+
+    G4ThreeVector polarization(cost * cosp, cost * sinp, -sint);
+    const G4ThreeVector perp = direction.cross(polarization);
+    phi = twopi * G4UniformRand();
+    sinp = std::sin(phi);
+    cosp = std::cos(phi);
+    polarization = (cosp * polarization + sinp * perp).unit();
+
+    auto* photon = new G4DynamicParticle(fOpticalPhoton, direction, record.spectrum->Sample(G4UniformRand()));
+    photon->SetPolarization(polarization);
+
+    const G4double u = G4UniformRand();
+    G4double time = record.time + u * record.duration;
+    if (record.decayTime > 0.) {
+        time += G4RandExponential::shoot(record.decayTime);
+    }
+
+    auto* track = new G4Track(photon, time, record.start + u * record.delta);
+    track->SetTouchableHandle(record.touchable);
+    track->SetParentID(record.parentID);
+    track->SetCreatorProcess(fScintillationProcess);
+    track->SetWeight(record.weight);
+    return track;
+}
@@ -0,0 +1,49 @@
+#include "PMStackingMessenger.hh"
+#include "PMStackingAction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+PMStackingMessenger::PMStackingMessenger(PMStackingConfig* config) : fConfig(config) {
+    fDirectory = new G4UIdirectory("/PM/stack/");
+    fDirectory->SetGuidance("Optical photon stacking.");
+
+    fLazyCmd = new G4UIcmdWithABool("/PM/stack/lazyScintillation", this);
+    fLazyCmd->SetGuidance("Keep one emission record per scintillating step and create its photons");
+    fLazyCmd->SetGuidance("in batches once the urgent stack is empty (bounded memory per event).");
+    fLazyCmd->SetParameterName("lazy", true);
+    fLazyCmd->SetDefaultValue(true);
+    fLazyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fLazyCmd->SetToBeBroadcasted(false);
+
+    fBatchSizeCmd = new G4UIcmdWithAnInteger("/PM/stack/batchSize", this);
+    fBatchSizeCmd->SetGuidance("Optical photons created per stage in lazy mode.");
+    fBatchSizeCmd->SetParameterName("photons", false);
+    fBatchSizeCmd->SetRange("photons > 0");
+    fBatchSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fBatchSizeCmd->SetToBeBroadcasted(false);
+}
+
+PMStackingMessenger::~PMStackingMessenger() {
+    delete fBatchSizeCmd;
+    delete fLazyCmd;
+    delete fDirectory;
+}
+
+void PMStackingMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fLazyCmd) {
+        fConfig->SetLazyScintillation(G4UIcmdWithABool::GetNewBoolValue(newValue));
+    } else if (command == fBatchSizeCmd) {
+        fConfig->SetBatchSize(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+    }
+}
+
+G4String PMStackingMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fLazyCmd) {
+        return G4UIcommand::ConvertToString(fConfig->IsLazyScintillation());
+    }
+    if (command == fBatchSizeCmd) {
+        return G4UIcommand::ConvertToString(fConfig->GetBatchSize());
+    }
+    return "";
+}
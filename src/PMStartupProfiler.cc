@@ -0,0 +1,74 @@
+#include "PMStartupProfiler.hh"
+#include "PMLog.hh"
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+G4Mutex profilerMutex = G4MUTEX_INITIALIZER;
+}
+
+PMStartupProfiler::PMStartupProfiler()
+    : fStart(Clock::now()),
+      fHavePhysicsMark(false),
+      fReported(false) {}
+
+PMStartupProfiler* PMStartupProfiler::Instance() {
+    static PMStartupProfiler* instance = new PMStartupProfiler();
+    return instance;
+}
+
+void PMStartupProfiler::Record(const G4String& phase, G4double seconds) {
+    G4AutoLock lock(&profilerMutex);
+    if (fReported) return;
+
+    auto it = std::find_if(fPhases.begin(), fPhases.end(),
+                           [&](const Phase& p) { return p.name == phase; });
+    if (it == fPhases.end()) {
+        fPhases.push_back({phase, 1, seconds, seconds});
+    } else {
+        ++it->calls;
+        it->total += seconds;
+        it->max = std::max(it->max, seconds);
+    }
+}
+
+void PMStartupProfiler::MarkPhysicsInitialized() {
+    G4AutoLock lock(&profilerMutex);
+    if (fReported) return;
+    fPhysicsInitialized = Clock::now();
+    fHavePhysicsMark = true;
+}
+
+void PMStartupProfiler::MarkRunStart() {
+    G4AutoLock lock(&profilerMutex);
+    if (fReported) return;
+
+    Clock::time_point now = Clock::now();
+    if (fHavePhysicsMark) {
+        std::chrono::duration<G4double> tables = now - fPhysicsInitialized;
+        fPhases.push_back({"physics tables", 1, tables.count(), tables.count()});
+    }
+    std::chrono::duration<G4double> total = now - fStart;
+    fPhases.push_back({"total to first run", 1, total.count(), total.count()});
+
+    Report();
+    fReported = true;
+}
+
+void PMStartupProfiler::Report() const {
+    std::ostringstream out;
+    out << "\n====== Startup Profile ======\n" << std::fixed << std::setprecision(3);
+    for (const Phase& phase : fPhases) {
+        out << "⏱ " << std::left << std::setw(24) << phase.name
+            << std::right << std::setw(9) << phase.total << " s";
+        if (phase.calls > 1) {
+            out << "  (" << phase.calls << " calls, max " << phase.max << " s)";
+        }
+        out << "\n";
+    }
+    out << "=============================";
+    PM_SUMMARY(out.str());
+}
@@ -0,0 +1,175 @@
+#include "PMStepProfiler.hh"
+#include "PMStepProfilerMessenger.hh"
+#include "PMLog.hh"
+#include "G4AutoLock.hh"
+#include "G4Exception.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <utility>
+
+G4ThreadLocal PMStepProfileTable* PMStepProfiler::fThreadTable = nullptr;
+
+namespace {
+// Owns the thread's table; fThreadTable points to it only while profiling.
+G4ThreadLocal PMStepProfileTable* threadStorage = nullptr;
+}
+
+PMStepProfileTable::PMStepProfileTable()
+    : fEntries(kCapacity + 1),
+      fUsed(0),
+      fLast(&fEntries[kCapacity]),
+      fSampleInterval(0),
+      fCountdown(0),
+      fArmedTrack(nullptr),
+      fArmedStep(0) {
+    Reset(0);
+}
+
+void PMStepProfileTable::Reset(G4int sampleInterval) {
+    std::fill(fEntries.begin(), fEntries.end(), Entry{nullptr, nullptr, nullptr, 0, 0, 0, 0.});
+    fUsed = 0;
+    fLast = &fEntries[kCapacity];
+    fSampleInterval = sampleInterval;
+    fCountdown = sampleInterval;
+    fArmedTrack = nullptr;
+}
+
+std::vector<const PMStepProfileTable::Entry*> PMStepProfileTable::GetEntries() const {
+    std::vector<const Entry*> entries;
+    for (const Entry& entry : fEntries) {
+        if (entry.steps > 0) {
+            entries.push_back(&entry);
+        }
+    }
+    return entries;
+}
+
+PMStepProfiler::PMStepProfiler()
+    : fEnabled(false),
+      fSampleInterval(64),
+      fFileName("step_profile"),
+      fMessenger(new PMStepProfilerMessenger(this)) {}
+
+PMStepProfiler* PMStepProfiler::Instance() {
+    static PMStepProfiler* instance = new PMStepProfiler();
+    return instance;
+}
+
+void PMStepProfiler::BeginOfRun() {
+    fMerged.clear();
+}
+
+void PMStepProfiler::BeginOfThreadRun() {
+    if (!fEnabled) {
+        fThreadTable = nullptr;
+        return;
+    }
+    if (!threadStorage) {
+        threadStorage = new PMStepProfileTable();
+    }
+    threadStorage->Reset(fSampleInterval);
+    fThreadTable = threadStorage;
+}
+
+void PMStepProfiler::MergeThreadTable() {
+    if (!fThreadTable) {
+        return;
+    }
+    G4AutoLock lock(&fMergeMutex);
+    for (const PMStepProfileTable::Entry* entry : fThreadTable->GetEntries()) {
+        G4String key = entry->particle
+                           ? entry->particle->GetParticleName() + ";"
+                                 + (entry->volume ? entry->volume->GetName() : G4String("none")) + ";"
+                                 + (entry->process ? entry->process->GetProcessName() : G4String("none"))
+                           : G4String("other;other;other");
+        Totals& totals = fMerged[key];
+        totals.steps += entry->steps;
+        totals.tracks += entry->tracks;
+        totals.sampledSteps += entry->sampledSteps;
+        totals.sampledNs += entry->sampledNs;
+    }
+    fThreadTable = nullptr;
+}
+
+void PMStepProfiler::EndOfRun() {
+    if (!fEnabled || fMerged.empty()) {
+        return;
+    }
+
+    // Unsampled keys are charged the mean time of all sampled steps.
+    G4long allSteps = 0, allSampled = 0;
+    G4double allSampledNs = 0.;
+    for (const auto& item : fMerged) {
+        allSteps += item.second.steps;
+        allSampled += item.second.sampledSteps;
+        allSampledNs += item.second.sampledNs;
+    }
+    const G4double meanNs = allSampled > 0 ? allSampledNs / allSampled : 0.;
+
+    struct Row {
+        const G4String* key;
+        const Totals* totals;
+        G4double nsPerStep;
+        G4double estimatedNs;
+    };
+    std::vector<Row> rows;
+    G4double allEstimatedNs = 0.;
+    for (const auto& item : fMerged) {
+        const Totals& totals = item.second;
+        G4double nsPerStep = totals.sampledSteps > 0 ? totals.sampledNs / totals.sampledSteps : meanNs;
+        rows.push_back({&item.first, &totals, nsPerStep, nsPerStep * totals.steps});
+        allEstimatedNs += nsPerStep * totals.steps;
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        return a.estimatedNs != b.estimatedNs ? a.estimatedNs > b.estimatedNs
+                                              : a.totals->steps > b.totals->steps;
+    });
+
+    G4String tableFile = fFileName + ".txt";
+    G4String foldedFile = fFileName + ".folded";
+    std::FILE* table = std::fopen(tableFile.c_str(), "w");
+    std::FILE* folded = std::fopen(foldedFile.c_str(), "w");
+    if (!table || !folded) {
+        if (table) std::fclose(table);
+        if (folded) std::fclose(folded);
+        G4ExceptionDescription msg;
+        msg << "Cannot write step profile to " << tableFile << " / " << foldedFile;
+        G4Exception("PMStepProfiler::EndOfRun", "PMProfile001", JustWarning, msg);
+        return;
+    }
+
+    std::fprintf(table, "# %ld steps, 1 in %d timed; time estimated as steps x sampled ns/step\n",
+                 static_cast<long>(allSteps), fSampleInterval);
+    std::fprintf(table, "%-48s %14s %12s %12s %10s %7s\n",
+                 "particle;volume;process", "steps", "tracks", "ns/step", "est. s", "%");
+    for (const Row& row : rows) {
+        G4double share = allEstimatedNs > 0. ? 100. * row.estimatedNs / allEstimatedNs
+                                             : 100. * row.totals->steps / allSteps;
+        std::fprintf(table, "%-48s %14ld %12ld %12.1f %10.4f %7.2f\n", row.key->c_str(),
+                     static_cast<long>(row.totals->steps), static_cast<long>(row.totals->tracks),
+                     row.nsPerStep, row.estimatedNs * 1e-9, share);
+        // Weights are microseconds, or steps when nothing was timed.
+        long weight = allEstimatedNs > 0. ? std::lround(row.estimatedNs * 1e-3)
+                                          : static_cast<long>(row.totals->steps);
+        if (weight > 0) {
+            std::fprintf(folded, "%s %ld\n", row.key->c_str(), weight);
+        }
+    }
+    std::fclose(table);
+    std::fclose(folded);
+
+    std::size_t nTop = std::min<std::size_t>(rows.size(), 10);
+    std::ostringstream top;
+    for (std::size_t i = 0; i < nTop; ++i) {
+        top << "\n  " << *rows[i].key << ": " << rows[i].totals->steps << " steps, "
+            << rows[i].estimatedNs * 1e-9 << " s";
+    }
+    PM_SUMMARY("✔ Step profile written to " << tableFile << " and " << foldedFile
+               << "; top entries:" << top.str());
+}
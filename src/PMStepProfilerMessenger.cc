@@ -0,0 +1,61 @@
+#include "PMStepProfilerMessenger.hh"
+#include "PMStepProfiler.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+
+PMStepProfilerMessenger::PMStepProfilerMessenger(PMStepProfiler* profiler) : fProfiler(profiler) {
+    fDirectory = new G4UIdirectory("/PM/profile/");
+    fDirectory->SetGuidance("Per-step accounting by particle, process and volume.");
+
+    fStepsCmd = new G4UIcmdWithABool("/PM/profile/steps", this);
+    fStepsCmd->SetGuidance("Count steps and tracks per (particle, process, volume) from the next run on.");
+    fStepsCmd->SetParameterName("enabled", true);
+    fStepsCmd->SetDefaultValue(true);
+    fStepsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fStepsCmd->SetToBeBroadcasted(false);
+
+    fSampleCmd = new G4UIcmdWithAnInteger("/PM/profile/sampleInterval", this);
+    fSampleCmd->SetGuidance("Time one step in every N (0: counts only).");
+    fSampleCmd->SetParameterName("N", false);
+    fSampleCmd->SetRange("N >= 0");
+    fSampleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fSampleCmd->SetToBeBroadcasted(false);
+
+    fFileCmd = new G4UIcmdWithAString("/PM/profile/file", this);
+    fFileCmd->SetGuidance("Output stem: <file>.txt (sorted table) and <file>.folded (flamegraph input).");
+    fFileCmd->SetParameterName("file", false);
+    fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fFileCmd->SetToBeBroadcasted(false);
+}
+
+PMStepProfilerMessenger::~PMStepProfilerMessenger() {
+    delete fFileCmd;
+    delete fSampleCmd;
+    delete fStepsCmd;
+    delete fDirectory;
+}
+
+void PMStepProfilerMessenger::SetNewValue(G4UIcommand* command, G4String newValue) {
+    if (command == fStepsCmd) {
+        fProfiler->SetEnabled(G4UIcmdWithABool::GetNewBoolValue(newValue));
+    } else if (command == fSampleCmd) {
+        fProfiler->SetSampleInterval(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+    } else if (command == fFileCmd) {
+        fProfiler->SetFileName(newValue);
+    }
+}
+
+G4String PMStepProfilerMessenger::GetCurrentValue(G4UIcommand* command) {
+    if (command == fStepsCmd) {
+        return G4UIcommand::ConvertToString(fProfiler->IsEnabled());
+    }
+    if (command == fSampleCmd) {
+        return G4UIcommand::ConvertToString(fProfiler->GetSampleInterval());
+    }
+    if (command == fFileCmd) {
+        return fProfiler->GetFileName();
+    }
+    return "";
+}
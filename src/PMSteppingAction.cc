@@ -1,77 +1,138 @@
 #include "PMSteppingAction.hh"
 #include "PMEventAction.hh"
+#include "PMStackingAction.hh"
+#include "PMLog.hh"
+#include "PMVolumeRegistry.hh"
+#include "PMOpticalResponse.hh"
+#include "PMPhotonRecordBuffer.hh"
+#include "PMStepProfiler.hh"
+#include "PMScoringMesh.hh"
+#include "PMAllocCounter.hh"
+#include "PMSensitiveDetector.hh"
 #include "G4Step.hh"
 #include "G4Track.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4OpticalPhoton.hh"
+#include "G4Gamma.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4VPhysicalVolume.hh"
 #include "G4VProcess.hh"
 #include "G4OpBoundaryProcess.hh"
 #include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
 
-PMSteppingAction::PMSteppingAction(PMEventAction* eventAction)
-    : G4UserSteppingAction(), fEventAction(eventAction) {}
+PMSteppingAction::PMSteppingAction(PMEventAction* eventAction, PMStackingAction* stackingAction)
+    : G4UserSteppingAction(),
+      fEventAction(eventAction),
+      fStackingAction(stackingAction),
+      fRegistry(PMVolumeRegistry::Instance()),
+      fResponse(PMOpticalResponse::Instance()),
+      fOpticalPhoton(G4OpticalPhoton::Definition()),
+      fGamma(G4Gamma::Definition()),
+      fBounces(0) {}
 
 PMSteppingAction::~PMSteppingAction() {}
 
 void PMSteppingAction::UserSteppingAction(const G4Step* step) {
+    PM_ALLOC_SCOPE(kStepping);
+    fEventAction->AddStep();
+    if (PMStepProfileTable* profile = PMStepProfiler::GetThreadTable()) {
+        profile->Record(step);
+    }
+
     G4Track* track = step->GetTrack();
-    G4ParticleDefinition* particle = track->GetDefinition();
+    const G4ParticleDefinition* particle = track->GetDefinition();
+    G4StepPoint* postStep = step->GetPostStepPoint();
+
+    if (particle == fOpticalPhoton) {
+        // Photons are tracked one at a time and never suspended, so the
+        // bounce counter only needs resetting on a track's first step.
+        if (track->GetCurrentStepNumber() == 1) {
+            fBounces = 0;
+        }
+
+        // The sensitive detector has already recorded the hit for this
+        // step; the same test, restricted to steps it saw, decides what
+        // happens to the photon here.
+        const G4bool detected =
+            step->GetPreStepPoint()->GetSensitiveDetector() && PMSensitiveDetector::IsDetection(step);
 
-    if (particle == G4OpticalPhoton::Definition()) {
-        G4VPhysicalVolume* preVolume = step->GetPreStepPoint()->GetPhysicalVolume();
-        if (preVolume && preVolume->GetName() == "AluminumPlate") {
-            if (fEventAction) {
-                fEventAction->AddAluminumPhoton();
+        const G4OpBoundaryProcess* boundary = PMVolumeRegistry::GetBoundaryProcess();
+        const G4bool atBoundary = boundary && postStep->GetProcessDefinedStep() == boundary;
+
+        if (detected) {
+            if (fResponse->GetMode() == PMOpticalResponse::kCalibrate) {
+                PMLightCollectionMap* map = fResponse->GetThreadMap();
+                G4ThreeVector vertex = PMVolumeRegistry::ToModuleFrame(
+                    step->GetPreStepPoint()->GetTouchable(), track->GetVertexPosition());
+                map->AddDetected(map->Index(vertex, track->GetVertexKineticEnergy()), track->GetWeight());
+            }
+            if (PMPhotonRecordBuffer* records = fEventAction ? fEventAction->GetPhotonRecords() : nullptr) {
+                records->Add(postStep->GetPosition() / mm, postStep->GetGlobalTime() / ns,
+                             h_Planck * c_light / step->GetPreStepPoint()->GetTotalEnergy() / nm,
+                             fBounces, track->GetVertexPosition() / mm, track->GetWeight());
             }
-            G4cout << "💡 [SteppingAction] Optical photon detected INSIDE AluminumPlate!" << G4endl;
+            PM_TRACE("💡 [SteppingAction] Optical photon detected at AluminumPlate!");
             track->SetTrackStatus(fStopAndKill);
-            return;
-        }
-        
-        G4StepPoint* postStep = step->GetPostStepPoint();
-        const G4VProcess* proc = postStep->GetProcessDefinedStep();
-        if (proc && proc->GetProcessName() == "OpBoundary") {
-            const G4OpBoundaryProcess* boundary = dynamic_cast<const G4OpBoundaryProcess*>(proc);
-            if (boundary) {
-                G4OpBoundaryProcessStatus status = boundary->GetStatus();
-                if (status == Detection || status == Absorption) {
-                    if (fEventAction) {
-                        fEventAction->AddAluminumPhoton();
-                    }
-                    G4cout << "💡 [SteppingAction] Optical photon detected at aluminum boundary (status = "
-                           << status << ")!" << G4endl;
+        } else if (atBoundary) {
+            ++fBounces;
+            const G4int rouletteBounces = fResponse->GetRouletteBounces();
+            if (rouletteBounces > 0 && fBounces % rouletteBounces == 0) {
+                const G4double survival = fResponse->GetRouletteSurvival();
+                if (G4UniformRand() < survival) {
+                    track->SetWeight(track->GetWeight() / survival);
+                } else {
                     track->SetTrackStatus(fStopAndKill);
-                    return;
                 }
             }
         }
         return;
     }
 
-    G4StepPoint* preStep  = step->GetPreStepPoint();
-    G4StepPoint* postStep = step->GetPostStepPoint();
+    const G4double edep = step->GetTotalEnergyDeposit();
+    if (edep > 0.) {
+        PMScoringGrid* mesh = PMScoringMesh::GetThreadGrid();
+        const G4bool recording = fStackingAction && fStackingAction->IsRecordingEmission();
+        const G4StepPoint* preStep = step->GetPreStepPoint();
+        if ((mesh || recording) &&
+            fRegistry->Classify(preStep->GetPhysicalVolume()) == PMVolumeID::kScintillator) {
+            if (recording) {
+                fStackingAction->RecordEmission(step);
+            }
+            if (mesh) {
+                const G4ThreeVector midpoint = 0.5 * (preStep->GetPosition() + postStep->GetPosition());
+                mesh->Add(PMScoringGrid::kEdep, PMVolumeRegistry::ToModuleFrame(preStep->GetTouchable(), midpoint),
+                          edep);
+            }
+        }
+    }
 
-    G4String particleName = particle->GetParticleName();
-    G4double kineticEnergy = preStep->GetKineticEnergy() / MeV;
-    G4VPhysicalVolume* volume = preStep->GetPhysicalVolume();
-    G4String volumeName = (volume) ? volume->GetName() : "None";
-    G4String processName = "None";
-    if (postStep->GetProcessDefinedStep()) {
-        processName = postStep->GetProcessDefinedStep()->GetProcessName();
+    if (particle == fGamma && postStep->GetStepStatus() == fGeomBoundary &&
+        fRegistry->Classify(postStep->GetPhysicalVolume()) == PMVolumeID::kTeflon && fEventAction) {
+        fEventAction->AddGammaToTeflon();
     }
-    G4double depositedEnergy = step->GetTotalEnergyDeposit() / MeV;
 
-    G4cout << "\n=== Step Information ===\n"
-           << "Particle: " << particleName << "\n"
-           << "Kinetic Energy: " << kineticEnergy << " MeV\n"
-           << "Current Volume: " << volumeName << "\n"
-           << "Process: " << processName << "\n"
-           << "Deposited Energy: " << depositedEnergy << " MeV\n"
-           << "=========================\n" << G4endl;
+#if PM_LOG_MAX_LEVEL >= 3
+    if (PM_TRACE_ENABLED()) {
+        G4double depositedEnergy = step->GetTotalEnergyDeposit() / MeV;
+        G4StepPoint* preStep  = step->GetPreStepPoint();
+
+        G4String particleName = particle->GetParticleName();
+        G4double kineticEnergy = preStep->GetKineticEnergy() / MeV;
+        G4VPhysicalVolume* volume = preStep->GetPhysicalVolume();
+        G4String volumeName = (volume) ? volume->GetName() : "None";
+        G4String processName = "None";
+        if (postStep->GetProcessDefinedStep()) {
+            processName = postStep->GetProcessDefinedStep()->GetProcessName();
+        }
 
-    if (depositedEnergy > 0 && fEventAction) {
-        fEventAction->RecordEnergy(depositedEnergy);
+        G4cout << "\n=== Step Information ===\n"
+               << "Particle: " << particleName << "\n"
+               << "Kinetic Energy: " << kineticEnergy << " MeV\n"
+               << "Current Volume: " << volumeName << "\n"
+               << "Process: " << processName << "\n"
+               << "Deposited Energy: " << depositedEnergy << " MeV\n"
+               << "=========================\n" << G4endl;
     }
+#endif
 }
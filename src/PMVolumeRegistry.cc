@@ -0,0 +1,54 @@
+#include "PMVolumeRegistry.hh"
+#include "G4OpBoundaryProcess.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
+#include "G4Exception.hh"
+
+G4ThreadLocal G4OpBoundaryProcess* PMVolumeRegistry::fBoundaryProcess = nullptr;
+
+PMVolumeRegistry::PMVolumeRegistry() : fVolumes{}, fIDs{}, fCount(0), fModuleCount(1) {}
+
+PMVolumeRegistry* PMVolumeRegistry::Instance() {
+    static PMVolumeRegistry instance;
+    return &instance;
+}
+
+void PMVolumeRegistry::Clear() {
+    fCount = 0;
+}
+
+void PMVolumeRegistry::Register(const G4LogicalVolume* logical, PMVolumeID id) {
+    for (G4int i = 0; i < fCount; ++i) {
+        if (fVolumes[i] == logical) {
+            fIDs[i] = id;
+            return;
+        }
+    }
+    if (fCount == kMaxVolumes) {
+        G4Exception("PMVolumeRegistry::Register", "PMVolume001", FatalException,
+                    "Too many volumes registered; raise kMaxVolumes.");
+        return;
+    }
+    fVolumes[fCount] = logical;
+    fIDs[fCount] = id;
+    ++fCount;
+}
+
+G4OpBoundaryProcess* PMVolumeRegistry::GetBoundaryProcess() {
+    if (fBoundaryProcess) {
+        return fBoundaryProcess;
+    }
+    G4ProcessManager* manager = G4OpticalPhoton::Definition()->GetProcessManager();
+    if (!manager) {
+        return nullptr;
+    }
+    G4ProcessVector* processes = manager->GetProcessList();
+    for (std::size_t i = 0; i < processes->size(); ++i) {
+        if (auto* boundary = dynamic_cast<G4OpBoundaryProcess*>((*processes)[i])) {
+            fBoundaryProcess = boundary;
+            break;
+        }
+    }
+    return fBoundaryProcess;
+}
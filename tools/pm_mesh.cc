@@ -0,0 +1,202 @@
+// Reader for the scoring mesh volumes written by /PM/mesh/enable
+// (<stem>_mesh.pmm, layout in src/PMScoringMesh.cc). Does not need Geant4.
+//
+//   pm_mesh info  file.pmm                      dimensions, occupancy, totals
+//   pm_mesh dense file.pmm edep|origins out.raw float32 volume, x fastest
+//   pm_mesh merge out.pmm file.pmm...           sum meshes of sharded runs
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char kMagic[8] = {'P', 'M', 'M', 'E', 'S', 'H', '0', '1'};
+constexpr int kBlockSize = 8;
+constexpr int kBlockVoxels = kBlockSize * kBlockSize * kBlockSize;
+const char* const kQuantityNames[] = {"edep", "origins"};
+
+struct Mesh {
+    int32_t nx = 0, ny = 0, nz = 0;
+    int32_t blockSize = 0, nQuantities = 0;
+    double geometry[4] = {};  // pitch, hx, hy, hz in mm
+    std::map<int32_t, std::vector<double>> blocks;  // nQuantities * 512 values each
+
+    int BlocksX() const { return (nx + kBlockSize - 1) / kBlockSize; }
+    int BlocksY() const { return (ny + kBlockSize - 1) / kBlockSize; }
+    int BlocksZ() const { return (nz + kBlockSize - 1) / kBlockSize; }
+    long NumberOfBlocks() const { return static_cast<long>(BlocksX()) * BlocksY() * BlocksZ(); }
+};
+
+bool Read(const std::string& fileName, Mesh& mesh) {
+    std::ifstream in(fileName, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    int32_t header[6];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        !in.read(reinterpret_cast<char*>(mesh.geometry), sizeof(mesh.geometry))) {
+        std::cerr << "pm_mesh: " << fileName << " is not a scoring mesh\n";
+        return false;
+    }
+    mesh.nx = header[0];
+    mesh.ny = header[1];
+    mesh.nz = header[2];
+    mesh.blockSize = header[3];
+    mesh.nQuantities = header[4];
+    if (mesh.blockSize != kBlockSize || mesh.nQuantities <= 0 || mesh.nx <= 0 || mesh.ny <= 0 ||
+        mesh.nz <= 0) {
+        std::cerr << "pm_mesh: " << fileName << ": unsupported block layout\n";
+        return false;
+    }
+    for (int32_t b = 0; b < header[5]; ++b) {
+        int32_t index;
+        std::vector<double> values(static_cast<std::size_t>(mesh.nQuantities) * kBlockVoxels);
+        if (!in.read(reinterpret_cast<char*>(&index), sizeof(index)) ||
+            !in.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(double))) {
+            std::cerr << "pm_mesh: " << fileName << " is truncated\n";
+            return false;
+        }
+        // Dense and merge place blocks by index; one outside the grid would
+        // land outside the volume or in another block's voxels.
+        if (index < 0 || index >= mesh.NumberOfBlocks()) {
+            std::cerr << "pm_mesh: " << fileName << ": block index " << index << " outside the "
+                      << mesh.NumberOfBlocks() << "-block grid\n";
+            return false;
+        }
+        mesh.blocks[index] = std::move(values);
+    }
+    return true;
+}
+
+bool Write(const std::string& fileName, const Mesh& mesh) {
+    std::ofstream out(fileName, std::ios::binary);
+    const int32_t header[6] = {mesh.nx, mesh.ny, mesh.nz, mesh.blockSize, mesh.nQuantities,
+                               static_cast<int32_t>(mesh.blocks.size())};
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(mesh.geometry), sizeof(mesh.geometry));
+    for (const auto& block : mesh.blocks) {
+        out.write(reinterpret_cast<const char*>(&block.first), sizeof(block.first));
+        out.write(reinterpret_cast<const char*>(block.second.data()), block.second.size() * sizeof(double));
+    }
+    if (!out) {
+        std::cerr << "pm_mesh: cannot write " << fileName << "\n";
+        return false;
+    }
+    return true;
+}
+
+int Info(const std::string& fileName) {
+    Mesh mesh;
+    if (!Read(fileName, mesh)) return 1;
+    const long totalBlocks = mesh.NumberOfBlocks();
+    std::printf("%s: %d x %d x %d voxels, pitch %g mm, box +-(%g, %g, %g) mm\n", fileName.c_str(), mesh.nx,
+                mesh.ny, mesh.nz, mesh.geometry[0], mesh.geometry[1], mesh.geometry[2], mesh.geometry[3]);
+    std::printf("blocks: %zu of %ld allocated\n", mesh.blocks.size(), totalBlocks);
+    for (int q = 0; q < mesh.nQuantities; ++q) {
+        double sum = 0.;
+        long nonZero = 0;
+        for (const auto& block : mesh.blocks) {
+            for (int v = 0; v < kBlockVoxels; ++v) {
+                const double value = block.second[static_cast<std::size_t>(q) * kBlockVoxels + v];
+                sum += value;
+                nonZero += value != 0.;
+            }
+        }
+        std::printf("%-8s total %.6g, %ld voxels non-zero\n", q < 2 ? kQuantityNames[q] : "?", sum, nonZero);
+    }
+    return 0;
+}
+
+int Dense(const std::string& fileName, const std::string& quantity, const std::string& outName) {
+    Mesh mesh;
+    if (!Read(fileName, mesh)) return 1;
+    int q = 0;
+    while (q < 2 && quantity != kQuantityNames[q]) ++q;
+    if (q >= mesh.nQuantities || q >= 2) {
+        std::cerr << "pm_mesh: unknown quantity " << quantity << " (edep or origins)\n";
+        return 1;
+    }
+    std::vector<float> volume(static_cast<std::size_t>(mesh.nx) * mesh.ny * mesh.nz, 0.f);
+    const int bx = mesh.BlocksX(), by = mesh.BlocksY();
+    for (const auto& block : mesh.blocks) {
+        const int x0 = block.first % bx * kBlockSize;
+        const int y0 = block.first / bx % by * kBlockSize;
+        const int z0 = block.first / (bx * by) * kBlockSize;
+        for (int v = 0; v < kBlockVoxels; ++v) {
+            const int x = x0 + (v & 7), y = y0 + (v >> 3 & 7), z = z0 + (v >> 6);
+            if (x < mesh.nx && y < mesh.ny && z < mesh.nz) {
+                volume[(static_cast<std::size_t>(z) * mesh.ny + y) * mesh.nx + x] =
+                    static_cast<float>(block.second[static_cast<std::size_t>(q) * kBlockVoxels + v]);
+            }
+        }
+    }
+    std::ofstream out(outName, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(volume.data()), volume.size() * sizeof(float));
+    if (!out) {
+        std::cerr << "pm_mesh: cannot write " << outName << "\n";
+        return 1;
+    }
+    std::printf("%s: %d x %d x %d float32, x fastest\n", outName.c_str(), mesh.nx, mesh.ny, mesh.nz);
+    return 0;
+}
+
+int Merge(const std::string& outName, const std::vector<std::string>& inputs) {
+    Mesh merged;
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        Mesh mesh;
+        if (!Read(inputs[i], mesh)) return 1;
+        if (i == 0) {
+            merged = std::move(mesh);
+            continue;
+        }
+        if (mesh.nx != merged.nx || mesh.ny != merged.ny || mesh.nz != merged.nz ||
+            mesh.nQuantities != merged.nQuantities ||
+            std::memcmp(mesh.geometry, merged.geometry, sizeof(mesh.geometry)) != 0) {
+            std::cerr << "pm_mesh: " << inputs[i] << " does not match the layout of " << inputs[0] << "\n";
+            return 1;
+        }
+        for (auto& block : mesh.blocks) {
+            std::vector<double>& target = merged.blocks[block.first];
+            if (target.empty()) {
+                target = std::move(block.second);
+                continue;
+            }
+            for (std::size_t v = 0; v < target.size(); ++v) {
+                target[v] += block.second[v];
+            }
+        }
+    }
+    if (!Write(outName, merged)) return 1;
+    std::printf("merged %zu meshes into %s\n", inputs.size(), outName.c_str());
+    return 0;
+}
+
+void PrintUsage() {
+    std::cerr << "Usage:\n"
+                 "  pm_mesh info  file.pmm\n"
+                 "  pm_mesh dense file.pmm edep|origins out.raw\n"
+                 "  pm_mesh merge out.pmm file.pmm...\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::string command = argc > 1 ? argv[1] : "";
+    if (command == "info" && argc == 3) {
+        return Info(argv[2]);
+    }
+    if (command == "dense" && argc == 5) {
+        return Dense(argv[2], argv[3], argv[4]);
+    }
+    if (command == "merge" && argc >= 4) {
+        return Merge(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+    }
+    PrintUsage();
+    return 1;
+}
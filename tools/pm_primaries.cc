@@ -0,0 +1,131 @@
+// Builds and inspects primary files for /PM/gun/file (see
+// PMPrimaryFormat.hh) without going through Geant4.
+//
+//   pm_primaries convert in.txt out.bin   text -> binary
+//   pm_primaries info file...             event and record counts, first records
+//
+// Text input: one particle per line,
+//   event pdg x[mm] y[mm] z[mm] dx dy dz E[MeV] t[ns]
+// with event numbers non-decreasing; '#' starts a comment. Event numbers
+// only group lines: gaps are dropped, so the file holds consecutive events.
+
+#include "PMPrimaryFormat.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+int Convert(const char* input, const char* output) {
+    std::ifstream in(input);
+    if (!in) {
+        std::cerr << "pm_primaries: cannot open " << input << "\n";
+        return 1;
+    }
+
+    std::vector<std::uint64_t> index;
+    std::vector<PMPrimaries::Record> records;
+    long lastEvent = -1;
+    std::string line;
+    for (long lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        const std::size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream fields(line);
+        long event;
+        PMPrimaries::Record record{};
+        double dir[3];
+        if (!(fields >> event)) continue;
+        if (!(fields >> record.pdg >> record.position[0] >> record.position[1] >> record.position[2]
+                    >> dir[0] >> dir[1] >> dir[2] >> record.energy >> record.time)) {
+            std::cerr << "pm_primaries: " << input << ":" << lineNumber << ": expected 10 fields\n";
+            return 1;
+        }
+        if (event < lastEvent) {
+            std::cerr << "pm_primaries: " << input << ":" << lineNumber << ": event numbers must not decrease\n";
+            return 1;
+        }
+        const double norm = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+        if (norm <= 0.) {
+            std::cerr << "pm_primaries: " << input << ":" << lineNumber << ": zero direction\n";
+            return 1;
+        }
+        for (int i = 0; i < 3; ++i) record.direction[i] = static_cast<float>(dir[i] / norm);
+        if (event != lastEvent) {
+            index.push_back(records.size());
+            lastEvent = event;
+        }
+        records.push_back(record);
+    }
+    if (records.empty()) {
+        std::cerr << "pm_primaries: no particles in " << input << "\n";
+        return 1;
+    }
+    index.push_back(records.size());
+
+    PMPrimaries::FileHeader header{};
+    std::memcpy(header.magic, PMPrimaries::kFileMagic, sizeof(header.magic));
+    header.nEvents = index.size() - 1;
+    header.nRecords = records.size();
+
+    std::FILE* out = std::fopen(output, "wb");
+    if (!out) {
+        std::cerr << "pm_primaries: cannot create " << output << "\n";
+        return 1;
+    }
+    const bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+                    std::fwrite(index.data(), sizeof(std::uint64_t), index.size(), out) == index.size() &&
+                    std::fwrite(records.data(), sizeof(PMPrimaries::Record), records.size(), out) == records.size();
+    if (std::fclose(out) != 0 || !ok) {
+        std::cerr << "pm_primaries: write to " << output << " failed\n";
+        return 1;
+    }
+    std::cout << output << ": " << header.nEvents << " events, " << header.nRecords << " particles\n";
+    return 0;
+}
+
+int Info(const char* fileName) {
+    std::FILE* in = std::fopen(fileName, "rb");
+    PMPrimaries::FileHeader header;
+    if (!in || std::fread(&header, sizeof(header), 1, in) != 1 ||
+        std::memcmp(header.magic, PMPrimaries::kFileMagic, sizeof(header.magic)) != 0) {
+        std::cerr << "pm_primaries: " << fileName << " is not a primary file\n";
+        if (in) std::fclose(in);
+        return 1;
+    }
+    std::cout << fileName << ": " << header.nEvents << " events, " << header.nRecords << " particles\n";
+    std::fseek(in, static_cast<long>(PMPrimaries::RecordOffset(header.nEvents)), SEEK_SET);
+    PMPrimaries::Record record;
+    for (int i = 0; i < 5 && std::fread(&record, sizeof(record), 1, in) == 1; ++i) {
+        std::printf("  pdg %d  E %.6g MeV  pos (%.4g, %.4g, %.4g) mm  dir (%.4g, %.4g, %.4g)  t %.4g ns\n",
+                    record.pdg, record.energy, record.position[0], record.position[1], record.position[2],
+                    record.direction[0], record.direction[1], record.direction[2], record.time);
+    }
+    std::fclose(in);
+    return 0;
+}
+
+void Usage() {
+    std::cerr << "Usage: pm_primaries convert in.txt out.bin\n"
+              << "       pm_primaries info file...\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && !std::strcmp(argv[1], "convert")) {
+        return Convert(argv[2], argv[3]);
+    }
+    if (argc >= 3 && !std::strcmp(argv[1], "info")) {
+        int status = 0;
+        for (int i = 2; i < argc; ++i) status |= Info(argv[i]);
+        return status;
+    }
+    Usage();
+    return 1;
+}
@@ -0,0 +1,281 @@
+// Merges the histogram and counter files of a sharded run (sim --shard i/N)
+// and checks merged results against a reference run. Works on the exact
+// text outputs of PMRunAction: <stem>_hist.txt and <stem>_counters.txt
+// (integers as integers, floating-point sums in %.17e).
+//
+//   pm_reduce merge   out_stem stem...   sum the shards in shard order
+//   pm_reduce compare stem_a stem_b      exit 0 if the results agree
+//
+// Histogram slots and integer counters must match bit for bit. The
+// floating-point run sums (energy deposit, aluminum weight) are added per
+// thread and per shard, so their rounding depends on how the events were
+// split; they are required to agree to 1e-12 relative.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Histogram {
+    std::string name;
+    int nBins = 0;
+    double min = 0.;
+    double max = 0.;
+    std::vector<double> slots;
+};
+
+struct Counter {
+    std::string name;
+    bool integer = true;
+    long long count = 0;
+    double value = 0.;
+};
+
+struct Result {
+    std::string stem;
+    int run = 0;
+    int shardIndex = 0;
+    int shardCount = 1;
+    long long seed = 0;
+    std::vector<Histogram> histograms;
+    std::vector<Counter> counters;
+};
+
+bool ReadHistograms(const std::string& fileName, std::vector<Histogram>& histograms) {
+    std::ifstream in(fileName);
+    if (!in) {
+        std::cerr << "pm_reduce: cannot open " << fileName << "\n";
+        return false;
+    }
+    std::string line;
+    if (!std::getline(in, line) || line != "# PMHistogramSet 1") {
+        std::cerr << "pm_reduce: " << fileName << " is not a histogram file\n";
+        return false;
+    }
+    while (std::getline(in, line)) {
+        std::istringstream header(line);
+        std::string keyword;
+        Histogram h;
+        if (!(header >> keyword >> h.name >> h.nBins >> h.min >> h.max) || keyword != "histogram") {
+            std::cerr << "pm_reduce: " << fileName << ": bad header '" << line << "'\n";
+            return false;
+        }
+        h.slots.resize(h.nBins + 2);
+        for (double& slot : h.slots) {
+            if (!std::getline(in, line)) {
+                std::cerr << "pm_reduce: " << fileName << ": " << h.name << " is truncated\n";
+                return false;
+            }
+            slot = std::strtod(line.c_str(), nullptr);
+        }
+        histograms.push_back(std::move(h));
+    }
+    return true;
+}
+
+bool ReadCounters(const std::string& fileName, Result& result) {
+    std::ifstream in(fileName);
+    if (!in) {
+        std::cerr << "pm_reduce: cannot open " << fileName << "\n";
+        return false;
+    }
+    std::string line;
+    if (!std::getline(in, line) || line != "# PMRunCounters 1") {
+        std::cerr << "pm_reduce: " << fileName << " is not a counter file\n";
+        return false;
+    }
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string key, value;
+        fields >> key >> value;
+        if (key == "run") {
+            result.run = std::atoi(value.c_str());
+        } else if (key == "shard") {
+            result.shardIndex = std::atoi(value.c_str());
+            fields >> result.shardCount;
+        } else if (key == "seed") {
+            result.seed = std::atoll(value.c_str());
+        } else if (!key.empty()) {
+            Counter c;
+            c.name = key;
+            c.integer = value.find_first_of(".eE") == std::string::npos;
+            c.count = std::atoll(value.c_str());
+            c.value = std::strtod(value.c_str(), nullptr);
+            result.counters.push_back(c);
+        }
+    }
+    return true;
+}
+
+bool Read(const std::string& stem, Result& result) {
+    result.stem = stem;
+    return ReadHistograms(stem + "_hist.txt", result.histograms) &&
+           ReadCounters(stem + "_counters.txt", result);
+}
+
+bool SameLayout(const Result& a, const Result& b) {
+    if (a.histograms.size() != b.histograms.size() || a.counters.size() != b.counters.size()) {
+        return false;
+    }
+    for (std::size_t h = 0; h < a.histograms.size(); ++h) {
+        const Histogram& x = a.histograms[h];
+        const Histogram& y = b.histograms[h];
+        if (x.name != y.name || x.nBins != y.nBins || x.min != y.min || x.max != y.max) return false;
+    }
+    for (std::size_t c = 0; c < a.counters.size(); ++c) {
+        if (a.counters[c].name != b.counters[c].name) return false;
+    }
+    return true;
+}
+
+bool Write(const std::string& stem, const Result& result) {
+    std::FILE* hist = std::fopen((stem + "_hist.txt").c_str(), "w");
+    std::FILE* counters = std::fopen((stem + "_counters.txt").c_str(), "w");
+    if (!hist || !counters) {
+        std::cerr << "pm_reduce: cannot write " << stem << "_*.txt\n";
+        if (hist) std::fclose(hist);
+        if (counters) std::fclose(counters);
+        return false;
+    }
+    std::fprintf(hist, "# PMHistogramSet 1\n");
+    for (const Histogram& h : result.histograms) {
+        std::fprintf(hist, "histogram %s %d %.17g %.17g\n", h.name.c_str(), h.nBins, h.min, h.max);
+        for (double slot : h.slots) {
+            std::fprintf(hist, "%.17g\n", slot);
+        }
+    }
+    std::fprintf(counters, "# PMRunCounters 1\n");
+    std::fprintf(counters, "run %d\n", result.run);
+    std::fprintf(counters, "shard %d %d\n", result.shardIndex, result.shardCount);
+    std::fprintf(counters, "seed %lld\n", result.seed);
+    for (const Counter& c : result.counters) {
+        if (c.integer) {
+            std::fprintf(counters, "%s %lld\n", c.name.c_str(), c.count);
+        } else {
+            std::fprintf(counters, "%s %.17e\n", c.name.c_str(), c.value);
+        }
+    }
+    const bool ok = std::fclose(hist) == 0;
+    return std::fclose(counters) == 0 && ok;
+}
+
+int Merge(const std::string& outStem, const std::vector<std::string>& stems) {
+    std::vector<Result> shards(stems.size());
+    for (std::size_t i = 0; i < stems.size(); ++i) {
+        if (!Read(stems[i], shards[i])) return 1;
+    }
+    std::sort(shards.begin(), shards.end(),
+              [](const Result& a, const Result& b) { return a.shardIndex < b.shardIndex; });
+
+    const Result& first = shards.front();
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        const Result& shard = shards[i];
+        if (shard.shardCount != static_cast<int>(shards.size()) || shard.shardIndex != static_cast<int>(i)) {
+            std::cerr << "pm_reduce: expected shards 0.." << shards.size() - 1 << " of "
+                      << shards.size() << " once each; " << shard.stem << " is shard "
+                      << shard.shardIndex << "/" << shard.shardCount << "\n";
+            return 1;
+        }
+        if (shard.seed != first.seed || shard.run != first.run || !SameLayout(shard, first)) {
+            std::cerr << "pm_reduce: " << shard.stem << " does not match " << first.stem
+                      << " (seed, run or layout)\n";
+            return 1;
+        }
+    }
+
+    Result merged = first;
+    merged.shardIndex = 0;
+    merged.shardCount = 1;
+    for (std::size_t i = 1; i < shards.size(); ++i) {
+        for (std::size_t h = 0; h < merged.histograms.size(); ++h) {
+            std::vector<double>& slots = merged.histograms[h].slots;
+            const std::vector<double>& add = shards[i].histograms[h].slots;
+            for (std::size_t s = 0; s < slots.size(); ++s) {
+                slots[s] += add[s];
+            }
+        }
+        for (std::size_t c = 0; c < merged.counters.size(); ++c) {
+            merged.counters[c].count += shards[i].counters[c].count;
+            merged.counters[c].value += shards[i].counters[c].value;
+        }
+    }
+    if (!Write(outStem, merged)) return 1;
+    std::cout << "merged " << shards.size() << " shards into " << outStem << "_*.txt\n";
+    return 0;
+}
+
+int Compare(const std::string& stemA, const std::string& stemB) {
+    Result a, b;
+    if (!Read(stemA, a) || !Read(stemB, b)) return 1;
+    if (!SameLayout(a, b)) {
+        std::cerr << "pm_reduce: " << stemA << " and " << stemB << " have different layouts\n";
+        return 1;
+    }
+    if (a.seed != b.seed) {
+        std::cerr << "pm_reduce: warning: master seeds differ (" << a.seed << " vs " << b.seed << ")\n";
+    }
+
+    int failures = 0;
+    for (std::size_t h = 0; h < a.histograms.size(); ++h) {
+        const Histogram& x = a.histograms[h];
+        const Histogram& y = b.histograms[h];
+        int differing = 0;
+        for (std::size_t s = 0; s < x.slots.size(); ++s) {
+            differing += x.slots[s] != y.slots[s];
+        }
+        std::cout << "histogram " << x.name << ": "
+                  << (differing ? std::to_string(differing) + " slots differ" : "identical") << "\n";
+        failures += differing != 0;
+    }
+    for (std::size_t c = 0; c < a.counters.size(); ++c) {
+        const Counter& x = a.counters[c];
+        const Counter& y = b.counters[c];
+        if (x.integer) {
+            const bool same = x.count == y.count;
+            std::cout << "counter " << x.name << ": " << x.count << " vs " << y.count
+                      << (same ? " identical" : " DIFFERENT") << "\n";
+            failures += !same;
+        } else {
+            const double scale = std::max(std::fabs(x.value), std::fabs(y.value));
+            const double relative = scale > 0. ? std::fabs(x.value - y.value) / scale : 0.;
+            const bool same = relative <= 1e-12;
+            std::printf("counter %s: %.17g vs %.17g %s (relative %.3g)\n", x.name.c_str(), x.value,
+                        y.value, x.value == y.value ? "identical" : same ? "rounding" : "DIFFERENT",
+                        relative);
+            failures += !same;
+        }
+    }
+    std::cout << (failures ? "MISMATCH" : "OK") << "\n";
+    return failures ? 2 : 0;
+}
+
+void PrintUsage() {
+    std::cerr << "Usage:\n"
+                 "  pm_reduce merge   out_stem stem...   sum <stem>_hist.txt / _counters.txt of all shards\n"
+                 "  pm_reduce compare stem_a stem_b      check a merged result against a reference run\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        PrintUsage();
+        return 1;
+    }
+    const std::string command = argv[1];
+    if (command == "merge" && argc >= 4) {
+        return Merge(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+    }
+    if (command == "compare" && argc == 4) {
+        return Compare(argv[2], argv[3]);
+    }
+    PrintUsage();
+    return 1;
+}
@@ -0,0 +1,258 @@
+// Reads and concatenates .pmc columnar files (see PMColumnarFormat.hh)
+// without going through Geant4 or a merge step.
+//
+//   pmc_tool info   file...            schema, chunk and row counts
+//   pmc_tool cat    file...            all rows as CSV, files back to back
+//   pmc_tool concat out.pmc file...    copy every chunk into one file
+
+#include "PMColumnarFormat.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef PM_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+struct Chunk {
+    PMColumnar::ChunkHeader header;
+    std::vector<PMColumnar::ColumnBlock> blocks;
+    std::vector<unsigned char> payload;
+};
+
+class Reader {
+public:
+    explicit Reader(const char* fileName) : fFile(std::fopen(fileName, "rb")), fName(fileName) {
+        if (!fFile) {
+            std::cerr << "pmc_tool: cannot open " << fileName << "\n";
+            return;
+        }
+        PMColumnar::FileHeader header;
+        if (std::fread(&header, sizeof(header), 1, fFile) != 1 ||
+            std::memcmp(header.magic, PMColumnar::kFileMagic, sizeof(header.magic)) != 0) {
+            std::cerr << "pmc_tool: " << fileName << " is not a .pmc file\n";
+            Close();
+            return;
+        }
+        fColumns.resize(header.nColumns);
+        if (std::fread(fColumns.data(), sizeof(PMColumnar::ColumnDesc), header.nColumns, fFile) !=
+            header.nColumns) {
+            std::cerr << "pmc_tool: " << fileName << " is truncated\n";
+            Close();
+        }
+    }
+
+    ~Reader() { Close(); }
+
+    bool IsValid() const { return fFile != nullptr; }
+    // Set when Next() stopped on a corrupt or truncated chunk rather than
+    // at the end of the file.
+    bool Failed() const { return fFailed; }
+    const std::vector<PMColumnar::ColumnDesc>& Columns() const { return fColumns; }
+
+    // False at the end of the file or on a bad chunk; see Failed().
+    bool Next(Chunk& chunk) {
+        if (!fFile) {
+            return false;
+        }
+        const std::size_t got = std::fread(&chunk.header, 1, sizeof(chunk.header), fFile);
+        if (got == 0 && std::feof(fFile)) {
+            return false;
+        }
+        if (got != sizeof(chunk.header)) {
+            return Fail("is truncated");
+        }
+        if (chunk.header.magic != PMColumnar::kChunkMagic || chunk.header.nColumns != fColumns.size() ||
+            (chunk.header.codec != PMColumnar::kRaw && chunk.header.codec != PMColumnar::kZlib)) {
+            return Fail("has a corrupt chunk header");
+        }
+        chunk.blocks.resize(chunk.header.nColumns);
+        if (std::fread(chunk.blocks.data(), sizeof(PMColumnar::ColumnBlock), chunk.blocks.size(), fFile) !=
+            chunk.blocks.size()) {
+            return Fail("is truncated");
+        }
+        // Decode and cat index the payload and the decoded columns by these
+        // sizes, so they must agree with the row count and codec.
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < chunk.blocks.size(); ++i) {
+            const auto& block = chunk.blocks[i];
+            if (block.rawBytes != std::uint64_t{chunk.header.nRows} * PMColumnar::TypeSize(fColumns[i].type) ||
+                (chunk.header.codec == PMColumnar::kRaw && block.storedBytes != block.rawBytes)) {
+                return Fail("has a corrupt column block");
+            }
+            bytes += PMColumnar::Padded(block.storedBytes);
+        }
+        chunk.payload.resize(bytes);
+        if (std::fread(chunk.payload.data(), 1, bytes, fFile) != bytes) {
+            return Fail("is truncated");
+        }
+        return true;
+    }
+
+private:
+    bool Fail(const char* what) {
+        std::cerr << "pmc_tool: " << fName << " " << what << "\n";
+        fFailed = true;
+        return false;
+    }
+
+    void Close() {
+        if (fFile) std::fclose(fFile);
+        fFile = nullptr;
+    }
+
+    std::FILE* fFile;
+    std::string fName;
+    bool fFailed = false;
+    std::vector<PMColumnar::ColumnDesc> fColumns;
+};
+
+// Decoded column i of a chunk, or empty on failure.
+std::vector<unsigned char> Decode(const Chunk& chunk, std::size_t column) {
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < column; ++i) offset += PMColumnar::Padded(chunk.blocks[i].storedBytes);
+    const auto& block = chunk.blocks[column];
+    std::vector<unsigned char> raw(block.rawBytes);
+
+    if (chunk.header.codec == PMColumnar::kRaw) {
+        std::memcpy(raw.data(), chunk.payload.data() + offset, block.rawBytes);
+        return raw;
+    }
+#ifdef PM_HAVE_ZLIB
+    uLongf size = block.rawBytes;
+    if (uncompress(raw.data(), &size, chunk.payload.data() + offset, block.storedBytes) == Z_OK &&
+        size == block.rawBytes) {
+        return raw;
+    }
+#endif
+    std::cerr << "pmc_tool: cannot decode column (built without zlib?)\n";
+    return {};
+}
+
+int Info(int argc, char** argv) {
+    for (int f = 0; f < argc; ++f) {
+        Reader reader(argv[f]);
+        if (!reader.IsValid()) return 1;
+        std::size_t chunks = 0, rows = 0, stored = 0, raw = 0;
+        Chunk chunk;
+        while (reader.Next(chunk)) {
+            ++chunks;
+            rows += chunk.header.nRows;
+            for (const auto& block : chunk.blocks) {
+                stored += block.storedBytes;
+                raw += block.rawBytes;
+            }
+        }
+        if (reader.Failed()) return 1;
+        std::cout << argv[f] << ": " << rows << " rows in " << chunks << " chunks, "
+                  << stored << " / " << raw << " bytes stored\n";
+        for (const auto& column : reader.Columns()) {
+            std::cout << "  " << column.name << " "
+                      << (column.type == PMColumnar::kInt32 ? "int32" : "float64") << "\n";
+        }
+    }
+    return 0;
+}
+
+int Cat(int argc, char** argv) {
+    bool printedHeader = false;
+    for (int f = 0; f < argc; ++f) {
+        Reader reader(argv[f]);
+        if (!reader.IsValid()) return 1;
+        const auto& columns = reader.Columns();
+        if (!printedHeader) {
+            for (std::size_t i = 0; i < columns.size(); ++i) {
+                std::cout << (i ? "," : "") << columns[i].name;
+            }
+            std::cout << "\n";
+            printedHeader = true;
+        }
+
+        Chunk chunk;
+        std::vector<std::vector<unsigned char>> decoded(columns.size());
+        while (reader.Next(chunk)) {
+            for (std::size_t i = 0; i < columns.size(); ++i) {
+                decoded[i] = Decode(chunk, i);
+                if (decoded[i].size() != chunk.blocks[i].rawBytes) return 1;
+            }
+            for (std::uint32_t row = 0; row < chunk.header.nRows; ++row) {
+                for (std::size_t i = 0; i < columns.size(); ++i) {
+                    if (i) std::cout << ",";
+                    if (columns[i].type == PMColumnar::kInt32) {
+                        std::int32_t value;
+                        std::memcpy(&value, decoded[i].data() + row * sizeof(value), sizeof(value));
+                        std::cout << value;
+                    } else {
+                        double value;
+                        std::memcpy(&value, decoded[i].data() + row * sizeof(value), sizeof(value));
+                        char text[32];
+                        std::snprintf(text, sizeof(text), "%.17g", value);
+                        std::cout << text;
+                    }
+                }
+                std::cout << "\n";
+            }
+        }
+        if (reader.Failed()) return 1;
+    }
+    return 0;
+}
+
+int Concat(int argc, char** argv) {
+    if (argc < 2) return 2;
+    std::FILE* out = std::fopen(argv[0], "wb");
+    if (!out) {
+        std::cerr << "pmc_tool: cannot create " << argv[0] << "\n";
+        return 1;
+    }
+
+    std::vector<PMColumnar::ColumnDesc> schema;
+    for (int f = 1; f < argc; ++f) {
+        Reader reader(argv[f]);
+        if (!reader.IsValid()) return 1;
+        const auto& columns = reader.Columns();
+        if (f == 1) {
+            schema = columns;
+            PMColumnar::FileHeader header{};
+            std::memcpy(header.magic, PMColumnar::kFileMagic, sizeof(header.magic));
+            header.nColumns = static_cast<std::uint32_t>(schema.size());
+            std::fwrite(&header, sizeof(header), 1, out);
+            std::fwrite(schema.data(), sizeof(PMColumnar::ColumnDesc), schema.size(), out);
+        } else if (columns.size() != schema.size() ||
+                   std::memcmp(columns.data(), schema.data(), schema.size() * sizeof(schema[0])) != 0) {
+            std::cerr << "pmc_tool: " << argv[f] << " has a different schema\n";
+            return 1;
+        }
+
+        // Chunks are self-contained: copy them verbatim.
+        Chunk chunk;
+        while (reader.Next(chunk)) {
+            std::fwrite(&chunk.header, sizeof(chunk.header), 1, out);
+            std::fwrite(chunk.blocks.data(), sizeof(PMColumnar::ColumnBlock), chunk.blocks.size(), out);
+            std::fwrite(chunk.payload.data(), 1, chunk.payload.size(), out);
+        }
+        if (reader.Failed()) {
+            std::fclose(out);
+            return 1;
+        }
+    }
+    return std::fclose(out) == 0 ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && !std::strcmp(argv[1], "info")) return Info(argc - 2, argv + 2);
+    if (argc >= 3 && !std::strcmp(argv[1], "cat")) return Cat(argc - 2, argv + 2);
+    if (argc >= 4 && !std::strcmp(argv[1], "concat")) return Concat(argc - 2, argv + 2);
+
+    std::cerr << "Usage: pmc_tool info file...\n"
+              << "       pmc_tool cat file...\n"
+              << "       pmc_tool concat out.pmc file...\n";
+    return 2;
+}